@@ -0,0 +1,422 @@
+#include "BatchKernels.h"
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FDSHA_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace FDSHA {
+
+    namespace {
+
+        // --- Scalar kernels (also used for the tail lanes of the SIMD kernels), for double and float ---
+
+        // Branch-free trapezoid: min(rise, fall, 1) inside the open support (a, d), 0 outside.
+        // Shoulders (a == b or c == d) divide by zero to +inf inside the support, which the min discards.
+        template <typename Real>
+        inline Real fuzzifyLane(const MembershipFunction& set, Real x) {
+            Real rise = (x - static_cast<Real>(set.a)) / static_cast<Real>(set.b - set.a);
+            Real fall = (static_cast<Real>(set.d) - x) / static_cast<Real>(set.d - set.c);
+            Real degree = std::min(std::min(rise, fall), Real(1));
+            return (x > static_cast<Real>(set.a) && x < static_cast<Real>(set.d)) ? degree : Real(0);
+        }
+
+        template <typename Real>
+        inline void inferLane(const Real* mmaxDegrees, const Real* rDegrees, const Real* fDegrees,
+                              const PGATerm* rules, Real* alphas, std::size_t n, std::size_t i) {
+            Real aggregated[PGA_TERM_COUNT] = {};
+            std::size_t rule = 0;
+            for (std::size_t m = 0; m < MAGNITUDE_TERM_COUNT; ++m) {
+                for (std::size_t r = 0; r < DISTANCE_TERM_COUNT; ++r) {
+                    Real mr = std::min(mmaxDegrees[m * n + i], rDegrees[r * n + i]);
+                    for (std::size_t f = 0; f < FAULT_TYPE_TERM_COUNT; ++f) {
+                        Real alpha = std::min(mr, fDegrees[f * n + i]);
+                        std::size_t term = toIndex(rules[rule++]);
+                        aggregated[term] = std::max(aggregated[term], alpha);
+                    }
+                }
+            }
+            for (std::size_t t = 0; t < PGA_TERM_COUNT; ++t) alphas[t * n + i] = aggregated[t];
+        }
+
+        template <typename Real>
+        inline Real defuzzifyLane(const Real* alphas, const Real* sampleMemberships, int sampleCount,
+                                  Real pgaMin, Real stepSize, Real fallback, std::size_t n, std::size_t i) {
+            Real numerator = 0;
+            Real denominator = 0;
+            for (int s = 0; s <= sampleCount; ++s) {
+                Real x = pgaMin + s * stepSize;
+                const Real* base = sampleMemberships + static_cast<std::size_t>(s) * PGA_TERM_COUNT;
+                Real aggregated = 0;
+                for (std::size_t t = 0; t < PGA_TERM_COUNT; ++t) {
+                    aggregated = std::max(aggregated, std::min(base[t], alphas[t * n + i]));
+                }
+                numerator += x * aggregated;
+                denominator += aggregated;
+            }
+            if (denominator == 0) return fallback;
+            return numerator / denominator;
+        }
+
+        template <typename Real>
+        void fuzzifyScalar(const MembershipFunction& set, const Real* x, Real* out, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) out[i] = fuzzifyLane(set, x[i]);
+        }
+
+        template <typename Real>
+        void inferScalar(const Real* mmaxDegrees, const Real* rDegrees, const Real* fDegrees,
+                         const PGATerm* rules, Real* alphas, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) inferLane(mmaxDegrees, rDegrees, fDegrees, rules, alphas, n, i);
+        }
+
+        template <typename Real>
+        void defuzzifySampledScalar(const Real* alphas, const Real* sampleMemberships, int sampleCount,
+                                    Real pgaMin, Real stepSize, Real fallback, Real* out, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = defuzzifyLane(alphas, sampleMemberships, sampleCount, pgaMin, stepSize, fallback, n, i);
+            }
+        }
+
+#ifdef FDSHA_X86_KERNELS
+        // --- SSE2 kernels (2 lanes) ---
+
+        __attribute__((target("sse2")))
+        void fuzzifySSE2(const MembershipFunction& set, const double* x, double* out, std::size_t n) {
+            const __m128d a = _mm_set1_pd(set.a);
+            const __m128d d = _mm_set1_pd(set.d);
+            const __m128d riseWidth = _mm_set1_pd(set.b - set.a);
+            const __m128d fallWidth = _mm_set1_pd(set.d - set.c);
+            const __m128d one = _mm_set1_pd(1.0);
+            std::size_t i = 0;
+            for (; i + 2 <= n; i += 2) {
+                __m128d v = _mm_loadu_pd(x + i);
+                __m128d rise = _mm_div_pd(_mm_sub_pd(v, a), riseWidth);
+                __m128d fall = _mm_div_pd(_mm_sub_pd(d, v), fallWidth);
+                __m128d degree = _mm_min_pd(_mm_min_pd(rise, fall), one);
+                __m128d inside = _mm_and_pd(_mm_cmpgt_pd(v, a), _mm_cmplt_pd(v, d));
+                _mm_storeu_pd(out + i, _mm_and_pd(inside, degree));
+            }
+            for (; i < n; ++i) out[i] = fuzzifyLane(set, x[i]);
+        }
+
+        __attribute__((target("sse2")))
+        void inferSSE2(const double* mmaxDegrees, const double* rDegrees, const double* fDegrees,
+                       const PGATerm* rules, double* alphas, std::size_t n) {
+            std::size_t i = 0;
+            for (; i + 2 <= n; i += 2) {
+                __m128d aggregated[PGA_TERM_COUNT];
+                for (auto& v : aggregated) v = _mm_setzero_pd();
+                std::size_t rule = 0;
+                for (std::size_t m = 0; m < MAGNITUDE_TERM_COUNT; ++m) {
+                    __m128d mDeg = _mm_loadu_pd(mmaxDegrees + m * n + i);
+                    for (std::size_t r = 0; r < DISTANCE_TERM_COUNT; ++r) {
+                        __m128d mr = _mm_min_pd(mDeg, _mm_loadu_pd(rDegrees + r * n + i));
+                        for (std::size_t f = 0; f < FAULT_TYPE_TERM_COUNT; ++f) {
+                            __m128d alpha = _mm_min_pd(mr, _mm_loadu_pd(fDegrees + f * n + i));
+                            std::size_t term = toIndex(rules[rule++]);
+                            aggregated[term] = _mm_max_pd(aggregated[term], alpha);
+                        }
+                    }
+                }
+                for (std::size_t t = 0; t < PGA_TERM_COUNT; ++t) _mm_storeu_pd(alphas + t * n + i, aggregated[t]);
+            }
+            for (; i < n; ++i) inferLane(mmaxDegrees, rDegrees, fDegrees, rules, alphas, n, i);
+        }
+
+        __attribute__((target("sse2")))
+        void defuzzifySampledSSE2(const double* alphas, const double* sampleMemberships, int sampleCount,
+                                  double pgaMin, double stepSize, double fallback, double* out, std::size_t n) {
+            std::size_t i = 0;
+            for (; i + 2 <= n; i += 2) {
+                __m128d alpha[PGA_TERM_COUNT];
+                for (std::size_t t = 0; t < PGA_TERM_COUNT; ++t) alpha[t] = _mm_loadu_pd(alphas + t * n + i);
+                __m128d numerator = _mm_setzero_pd();
+                __m128d denominator = _mm_setzero_pd();
+                for (int s = 0; s <= sampleCount; ++s) {
+                    __m128d x = _mm_set1_pd(pgaMin + s * stepSize);
+                    const double* base = sampleMemberships + static_cast<std::size_t>(s) * PGA_TERM_COUNT;
+                    __m128d aggregated = _mm_setzero_pd();
+                    for (std::size_t t = 0; t < PGA_TERM_COUNT; ++t) {
+                        aggregated = _mm_max_pd(aggregated, _mm_min_pd(_mm_set1_pd(base[t]), alpha[t]));
+                    }
+                    numerator = _mm_add_pd(numerator, _mm_mul_pd(x, aggregated));
+                    denominator = _mm_add_pd(denominator, aggregated);
+                }
+                __m128d empty = _mm_cmpeq_pd(denominator, _mm_setzero_pd());
+                __m128d result = _mm_div_pd(numerator, denominator);
+                result = _mm_or_pd(_mm_and_pd(empty, _mm_set1_pd(fallback)), _mm_andnot_pd(empty, result));
+                _mm_storeu_pd(out + i, result);
+            }
+            for (; i < n; ++i) {
+                out[i] = defuzzifyLane(alphas, sampleMemberships, sampleCount, pgaMin, stepSize, fallback, n, i);
+            }
+        }
+
+        // --- AVX2 kernels (4 lanes) ---
+
+        __attribute__((target("avx2")))
+        void fuzzifyAVX2(const MembershipFunction& set, const double* x, double* out, std::size_t n) {
+            const __m256d a = _mm256_set1_pd(set.a);
+            const __m256d d = _mm256_set1_pd(set.d);
+            const __m256d riseWidth = _mm256_set1_pd(set.b - set.a);
+            const __m256d fallWidth = _mm256_set1_pd(set.d - set.c);
+            const __m256d one = _mm256_set1_pd(1.0);
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                __m256d v = _mm256_loadu_pd(x + i);
+                __m256d rise = _mm256_div_pd(_mm256_sub_pd(v, a), riseWidth);
+                __m256d fall = _mm256_div_pd(_mm256_sub_pd(d, v), fallWidth);
+                __m256d degree = _mm256_min_pd(_mm256_min_pd(rise, fall), one);
+                __m256d inside = _mm256_and_pd(_mm256_cmp_pd(v, a, _CMP_GT_OQ), _mm256_cmp_pd(v, d, _CMP_LT_OQ));
+                _mm256_storeu_pd(out + i, _mm256_and_pd(inside, degree));
+            }
+            for (; i < n; ++i) out[i] = fuzzifyLane(set, x[i]);
+        }
+
+        __attribute__((target("avx2")))
+        void inferAVX2(const double* mmaxDegrees, const double* rDegrees, const double* fDegrees,
+                       const PGATerm* rules, double* alphas, std::size_t n) {
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                __m256d aggregated[PGA_TERM_COUNT];
+                for (auto& v : aggregated) v = _mm256_setzero_pd();
+                std::size_t rule = 0;
+                for (std::size_t m = 0; m < MAGNITUDE_TERM_COUNT; ++m) {
+                    __m256d mDeg = _mm256_loadu_pd(mmaxDegrees + m * n + i);
+                    for (std::size_t r = 0; r < DISTANCE_TERM_COUNT; ++r) {
+                        __m256d mr = _mm256_min_pd(mDeg, _mm256_loadu_pd(rDegrees + r * n + i));
+                        for (std::size_t f = 0; f < FAULT_TYPE_TERM_COUNT; ++f) {
+                            __m256d alpha = _mm256_min_pd(mr, _mm256_loadu_pd(fDegrees + f * n + i));
+                            std::size_t term = toIndex(rules[rule++]);
+                            aggregated[term] = _mm256_max_pd(aggregated[term], alpha);
+                        }
+                    }
+                }
+                for (std::size_t t = 0; t < PGA_TERM_COUNT; ++t) _mm256_storeu_pd(alphas + t * n + i, aggregated[t]);
+            }
+            for (; i < n; ++i) inferLane(mmaxDegrees, rDegrees, fDegrees, rules, alphas, n, i);
+        }
+
+        __attribute__((target("avx2")))
+        void defuzzifySampledAVX2(const double* alphas, const double* sampleMemberships, int sampleCount,
+                                  double pgaMin, double stepSize, double fallback, double* out, std::size_t n) {
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                __m256d alpha[PGA_TERM_COUNT];
+                for (std::size_t t = 0; t < PGA_TERM_COUNT; ++t) alpha[t] = _mm256_loadu_pd(alphas + t * n + i);
+                __m256d numerator = _mm256_setzero_pd();
+                __m256d denominator = _mm256_setzero_pd();
+                for (int s = 0; s <= sampleCount; ++s) {
+                    __m256d x = _mm256_set1_pd(pgaMin + s * stepSize);
+                    const double* base = sampleMemberships + static_cast<std::size_t>(s) * PGA_TERM_COUNT;
+                    __m256d aggregated = _mm256_setzero_pd();
+                    for (std::size_t t = 0; t < PGA_TERM_COUNT; ++t) {
+                        aggregated = _mm256_max_pd(aggregated, _mm256_min_pd(_mm256_set1_pd(base[t]), alpha[t]));
+                    }
+                    numerator = _mm256_add_pd(numerator, _mm256_mul_pd(x, aggregated));
+                    denominator = _mm256_add_pd(denominator, aggregated);
+                }
+                __m256d empty = _mm256_cmp_pd(denominator, _mm256_setzero_pd(), _CMP_EQ_OQ);
+                __m256d result = _mm256_div_pd(numerator, denominator);
+                result = _mm256_blendv_pd(result, _mm256_set1_pd(fallback), empty);
+                _mm256_storeu_pd(out + i, result);
+            }
+            for (; i < n; ++i) {
+                out[i] = defuzzifyLane(alphas, sampleMemberships, sampleCount, pgaMin, stepSize, fallback, n, i);
+            }
+        }
+
+        // --- Single-precision SSE2 kernels (4 lanes) ---
+
+        __attribute__((target("sse2")))
+        void fuzzifyFloatSSE2(const MembershipFunction& set, const float* x, float* out, std::size_t n) {
+            const __m128 a = _mm_set1_ps(static_cast<float>(set.a));
+            const __m128 d = _mm_set1_ps(static_cast<float>(set.d));
+            const __m128 riseWidth = _mm_set1_ps(static_cast<float>(set.b - set.a));
+            const __m128 fallWidth = _mm_set1_ps(static_cast<float>(set.d - set.c));
+            const __m128 one = _mm_set1_ps(1.0f);
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                __m128 v = _mm_loadu_ps(x + i);
+                __m128 rise = _mm_div_ps(_mm_sub_ps(v, a), riseWidth);
+                __m128 fall = _mm_div_ps(_mm_sub_ps(d, v), fallWidth);
+                __m128 degree = _mm_min_ps(_mm_min_ps(rise, fall), one);
+                __m128 inside = _mm_and_ps(_mm_cmpgt_ps(v, a), _mm_cmplt_ps(v, d));
+                _mm_storeu_ps(out + i, _mm_and_ps(inside, degree));
+            }
+            for (; i < n; ++i) out[i] = fuzzifyLane(set, x[i]);
+        }
+
+        __attribute__((target("sse2")))
+        void inferFloatSSE2(const float* mmaxDegrees, const float* rDegrees, const float* fDegrees,
+                            const PGATerm* rules, float* alphas, std::size_t n) {
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                __m128 aggregated[PGA_TERM_COUNT];
+                for (auto& v : aggregated) v = _mm_setzero_ps();
+                std::size_t rule = 0;
+                for (std::size_t m = 0; m < MAGNITUDE_TERM_COUNT; ++m) {
+                    __m128 mDeg = _mm_loadu_ps(mmaxDegrees + m * n + i);
+                    for (std::size_t r = 0; r < DISTANCE_TERM_COUNT; ++r) {
+                        __m128 mr = _mm_min_ps(mDeg, _mm_loadu_ps(rDegrees + r * n + i));
+                        for (std::size_t f = 0; f < FAULT_TYPE_TERM_COUNT; ++f) {
+                            __m128 alpha = _mm_min_ps(mr, _mm_loadu_ps(fDegrees + f * n + i));
+                            std::size_t term = toIndex(rules[rule++]);
+                            aggregated[term] = _mm_max_ps(aggregated[term], alpha);
+                        }
+                    }
+                }
+                for (std::size_t t = 0; t < PGA_TERM_COUNT; ++t) _mm_storeu_ps(alphas + t * n + i, aggregated[t]);
+            }
+            for (; i < n; ++i) inferLane(mmaxDegrees, rDegrees, fDegrees, rules, alphas, n, i);
+        }
+
+        __attribute__((target("sse2")))
+        void defuzzifySampledFloatSSE2(const float* alphas, const float* sampleMemberships, int sampleCount,
+                                       float pgaMin, float stepSize, float fallback, float* out, std::size_t n) {
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                __m128 alpha[PGA_TERM_COUNT];
+                for (std::size_t t = 0; t < PGA_TERM_COUNT; ++t) alpha[t] = _mm_loadu_ps(alphas + t * n + i);
+                __m128 numerator = _mm_setzero_ps();
+                __m128 denominator = _mm_setzero_ps();
+                for (int s = 0; s <= sampleCount; ++s) {
+                    __m128 x = _mm_set1_ps(pgaMin + s * stepSize);
+                    const float* base = sampleMemberships + static_cast<std::size_t>(s) * PGA_TERM_COUNT;
+                    __m128 aggregated = _mm_setzero_ps();
+                    for (std::size_t t = 0; t < PGA_TERM_COUNT; ++t) {
+                        aggregated = _mm_max_ps(aggregated, _mm_min_ps(_mm_set1_ps(base[t]), alpha[t]));
+                    }
+                    numerator = _mm_add_ps(numerator, _mm_mul_ps(x, aggregated));
+                    denominator = _mm_add_ps(denominator, aggregated);
+                }
+                __m128 empty = _mm_cmpeq_ps(denominator, _mm_setzero_ps());
+                __m128 result = _mm_div_ps(numerator, denominator);
+                result = _mm_or_ps(_mm_and_ps(empty, _mm_set1_ps(fallback)), _mm_andnot_ps(empty, result));
+                _mm_storeu_ps(out + i, result);
+            }
+            for (; i < n; ++i) {
+                out[i] = defuzzifyLane(alphas, sampleMemberships, sampleCount, pgaMin, stepSize, fallback, n, i);
+            }
+        }
+
+        // --- Single-precision AVX2 kernels (8 lanes) ---
+
+        __attribute__((target("avx2")))
+        void fuzzifyFloatAVX2(const MembershipFunction& set, const float* x, float* out, std::size_t n) {
+            const __m256 a = _mm256_set1_ps(static_cast<float>(set.a));
+            const __m256 d = _mm256_set1_ps(static_cast<float>(set.d));
+            const __m256 riseWidth = _mm256_set1_ps(static_cast<float>(set.b - set.a));
+            const __m256 fallWidth = _mm256_set1_ps(static_cast<float>(set.d - set.c));
+            const __m256 one = _mm256_set1_ps(1.0f);
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m256 v = _mm256_loadu_ps(x + i);
+                __m256 rise = _mm256_div_ps(_mm256_sub_ps(v, a), riseWidth);
+                __m256 fall = _mm256_div_ps(_mm256_sub_ps(d, v), fallWidth);
+                __m256 degree = _mm256_min_ps(_mm256_min_ps(rise, fall), one);
+                __m256 inside = _mm256_and_ps(_mm256_cmp_ps(v, a, _CMP_GT_OQ), _mm256_cmp_ps(v, d, _CMP_LT_OQ));
+                _mm256_storeu_ps(out + i, _mm256_and_ps(inside, degree));
+            }
+            for (; i < n; ++i) out[i] = fuzzifyLane(set, x[i]);
+        }
+
+        __attribute__((target("avx2")))
+        void inferFloatAVX2(const float* mmaxDegrees, const float* rDegrees, const float* fDegrees,
+                            const PGATerm* rules, float* alphas, std::size_t n) {
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m256 aggregated[PGA_TERM_COUNT];
+                for (auto& v : aggregated) v = _mm256_setzero_ps();
+                std::size_t rule = 0;
+                for (std::size_t m = 0; m < MAGNITUDE_TERM_COUNT; ++m) {
+                    __m256 mDeg = _mm256_loadu_ps(mmaxDegrees + m * n + i);
+                    for (std::size_t r = 0; r < DISTANCE_TERM_COUNT; ++r) {
+                        __m256 mr = _mm256_min_ps(mDeg, _mm256_loadu_ps(rDegrees + r * n + i));
+                        for (std::size_t f = 0; f < FAULT_TYPE_TERM_COUNT; ++f) {
+                            __m256 alpha = _mm256_min_ps(mr, _mm256_loadu_ps(fDegrees + f * n + i));
+                            std::size_t term = toIndex(rules[rule++]);
+                            aggregated[term] = _mm256_max_ps(aggregated[term], alpha);
+                        }
+                    }
+                }
+                for (std::size_t t = 0; t < PGA_TERM_COUNT; ++t) _mm256_storeu_ps(alphas + t * n + i, aggregated[t]);
+            }
+            for (; i < n; ++i) inferLane(mmaxDegrees, rDegrees, fDegrees, rules, alphas, n, i);
+        }
+
+        __attribute__((target("avx2")))
+        void defuzzifySampledFloatAVX2(const float* alphas, const float* sampleMemberships, int sampleCount,
+                                       float pgaMin, float stepSize, float fallback, float* out, std::size_t n) {
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                __m256 alpha[PGA_TERM_COUNT];
+                for (std::size_t t = 0; t < PGA_TERM_COUNT; ++t) alpha[t] = _mm256_loadu_ps(alphas + t * n + i);
+                __m256 numerator = _mm256_setzero_ps();
+                __m256 denominator = _mm256_setzero_ps();
+                for (int s = 0; s <= sampleCount; ++s) {
+                    __m256 x = _mm256_set1_ps(pgaMin + s * stepSize);
+                    const float* base = sampleMemberships + static_cast<std::size_t>(s) * PGA_TERM_COUNT;
+                    __m256 aggregated = _mm256_setzero_ps();
+                    for (std::size_t t = 0; t < PGA_TERM_COUNT; ++t) {
+                        aggregated = _mm256_max_ps(aggregated, _mm256_min_ps(_mm256_set1_ps(base[t]), alpha[t]));
+                    }
+                    numerator = _mm256_add_ps(numerator, _mm256_mul_ps(x, aggregated));
+                    denominator = _mm256_add_ps(denominator, aggregated);
+                }
+                __m256 empty = _mm256_cmp_ps(denominator, _mm256_setzero_ps(), _CMP_EQ_OQ);
+                __m256 result = _mm256_div_ps(numerator, denominator);
+                result = _mm256_blendv_ps(result, _mm256_set1_ps(fallback), empty);
+                _mm256_storeu_ps(out + i, result);
+            }
+            for (; i < n; ++i) {
+                out[i] = defuzzifyLane(alphas, sampleMemberships, sampleCount, pgaMin, stepSize, fallback, n, i);
+            }
+        }
+#endif // FDSHA_X86_KERNELS
+
+        const BatchKernels SCALAR_KERNELS = { SimdLevel::Scalar, fuzzifyScalar<double>, inferScalar<double>, defuzzifySampledScalar<double> };
+        const FloatBatchKernels FLOAT_SCALAR_KERNELS = { SimdLevel::Scalar, fuzzifyScalar<float>, inferScalar<float>, defuzzifySampledScalar<float> };
+#ifdef FDSHA_X86_KERNELS
+        const BatchKernels SSE2_KERNELS = { SimdLevel::SSE2, fuzzifySSE2, inferSSE2, defuzzifySampledSSE2 };
+        const BatchKernels AVX2_KERNELS = { SimdLevel::AVX2, fuzzifyAVX2, inferAVX2, defuzzifySampledAVX2 };
+        const FloatBatchKernels FLOAT_SSE2_KERNELS = { SimdLevel::SSE2, fuzzifyFloatSSE2, inferFloatSSE2, defuzzifySampledFloatSSE2 };
+        const FloatBatchKernels FLOAT_AVX2_KERNELS = { SimdLevel::AVX2, fuzzifyFloatAVX2, inferFloatAVX2, defuzzifySampledFloatAVX2 };
+#endif
+
+    } // namespace
+
+    SimdLevel detectSimdLevel() {
+#ifdef FDSHA_X86_KERNELS
+        static const SimdLevel detected = [] {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+            if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE2;
+            return SimdLevel::Scalar;
+        }();
+        return detected;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+
+    const BatchKernels& getBatchKernels(SimdLevel level) {
+        SimdLevel usable = std::min(level, detectSimdLevel());
+#ifdef FDSHA_X86_KERNELS
+        if (usable == SimdLevel::AVX2) return AVX2_KERNELS;
+        if (usable == SimdLevel::SSE2) return SSE2_KERNELS;
+#endif
+        return SCALAR_KERNELS;
+    }
+
+    const FloatBatchKernels& getFloatBatchKernels(SimdLevel level) {
+        SimdLevel usable = std::min(level, detectSimdLevel());
+#ifdef FDSHA_X86_KERNELS
+        if (usable == SimdLevel::AVX2) return FLOAT_AVX2_KERNELS;
+        if (usable == SimdLevel::SSE2) return FLOAT_SSE2_KERNELS;
+#endif
+        return FLOAT_SCALAR_KERNELS;
+    }
+
+} // namespace FDSHA
@@ -0,0 +1,62 @@
+#ifndef BATCHKERNELS_H
+#define BATCHKERNELS_H
+
+#include "Enums.h"
+#include "FuzzySet.h"
+#include <cstddef>
+
+namespace FDSHA {
+
+    // Instruction set used by the batch kernels
+    enum class SimdLevel { Scalar, SSE2, AVX2 };
+
+    /**
+     * @brief Table of lane-parallel kernels for one instruction set.
+     *
+     * All arrays are structure-of-arrays: term-major blocks of n lanes, i.e. the
+     * degree of term k for lane i lives at [k * n + i].
+     */
+    struct BatchKernels {
+        SimdLevel Level;
+
+        // out[i] = set(x[i]), branch-free
+        void (*fuzzify)(const MembershipFunction& set, const double* x, double* out, std::size_t n);
+
+        // alphas[t * n + i] = MAX over rules with consequent t of MIN(mmax, r, f) degrees.
+        // rules is the dense rule cube in Mmax-major, F-minor order.
+        void (*infer)(const double* mmaxDegrees, const double* rDegrees, const double* fDegrees,
+                      const PGATerm* rules, double* alphas, std::size_t n);
+
+        // out[i] = sampled COG of lane i, or fallback if nothing fired. sampleMemberships holds
+        // the PGA set degrees at each of the (sampleCount + 1) sample points, term-minor.
+        void (*defuzzifySampled)(const double* alphas, const double* sampleMemberships, int sampleCount,
+                                 double pgaMin, double stepSize, double fallback, double* out, std::size_t n);
+    };
+
+    /**
+     * @brief Single-precision BatchKernels: the same layout and operations on float, with twice
+     *        the lanes per register.
+     */
+    struct FloatBatchKernels {
+        SimdLevel Level;
+        void (*fuzzify)(const MembershipFunction& set, const float* x, float* out, std::size_t n);
+        void (*infer)(const float* mmaxDegrees, const float* rDegrees, const float* fDegrees,
+                      const PGATerm* rules, float* alphas, std::size_t n);
+        void (*defuzzifySampled)(const float* alphas, const float* sampleMemberships, int sampleCount,
+                                 float pgaMin, float stepSize, float fallback, float* out, std::size_t n);
+    };
+
+    /**
+     * @brief Best instruction set supported by the running CPU.
+     */
+    SimdLevel detectSimdLevel();
+
+    /**
+     * @brief Kernels for the requested level, falling back to the best supported one below it.
+     */
+    const BatchKernels& getBatchKernels(SimdLevel level);
+    const FloatBatchKernels& getFloatBatchKernels(SimdLevel level);
+
+} // namespace FDSHA
+
+#endif // BATCHKERNELS_H
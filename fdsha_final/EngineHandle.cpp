@@ -0,0 +1,30 @@
+#include "EngineHandle.h"
+#include <stdexcept>
+
+namespace FDSHA {
+
+    EngineHandle::EngineHandle(std::shared_ptr<const FDSHAEngine> engine) {
+        if (!engine) throw std::invalid_argument("EngineHandle: engine must not be null");
+        std::atomic_store(&Current, std::move(engine));
+    }
+
+    void EngineHandle::publish(std::shared_ptr<const FDSHAEngine> engine) {
+        if (!engine) throw std::invalid_argument("EngineHandle: engine must not be null");
+        std::lock_guard<std::mutex> lock(PublishMutex);
+        std::atomic_store(&Current, std::move(engine));
+    }
+
+    std::shared_ptr<const FDSHAEngine> EngineHandle::swapModel(const FuzzyModel& model) {
+        // Validate and compile before taking the lock; readers never wait on either
+        auto next = std::make_shared<FDSHAEngine>(model);
+
+        std::lock_guard<std::mutex> lock(PublishMutex);
+        std::shared_ptr<const FDSHAEngine> previous = std::atomic_load(&Current);
+        next->setDefuzzificationMethod(previous->getDefuzzificationMethod());
+        next->setSampleCount(previous->getSampleCount());
+        next->setSimdLevel(previous->getSimdLevel());
+        std::atomic_store(&Current, std::shared_ptr<const FDSHAEngine>(std::move(next)));
+        return previous;
+    }
+
+} // namespace FDSHA
@@ -0,0 +1,50 @@
+#ifndef ENGINEHANDLE_H
+#define ENGINEHANDLE_H
+
+#include "FDSHAEngine.h"
+#include "FuzzyModel.h"
+#include <memory>
+#include <mutex>
+
+namespace FDSHA {
+
+    /**
+     * @brief Atomically replaceable engine for processes that keep serving while the model changes.
+     *
+     * Readers call acquire() once per request or batch and run on that snapshot; the engine is
+     * immutable, so a snapshot stays valid (and consistent) for as long as it is held, even after
+     * a newer engine has been published. Publishing swaps a shared_ptr with std::atomic_store:
+     * readers never wait for a model to be parsed, validated or compiled, and the old engine is
+     * freed when its last reader drops it.
+     */
+    class EngineHandle {
+    private:
+        std::shared_ptr<const FDSHAEngine> Current;
+
+        // Serializes publishers so swapModel() reads and replaces the same engine
+        std::mutex PublishMutex;
+
+    public:
+        explicit EngineHandle(std::shared_ptr<const FDSHAEngine> engine);
+
+        EngineHandle(const EngineHandle&) = delete;
+        EngineHandle& operator=(const EngineHandle&) = delete;
+
+        std::shared_ptr<const FDSHAEngine> acquire() const { return std::atomic_load(&Current); }
+
+        /**
+         * @brief Publishes engine to every later acquire(). Throws std::invalid_argument on null.
+         */
+        void publish(std::shared_ptr<const FDSHAEngine> engine);
+
+        /**
+         * @brief Compiles model into a new engine with the current engine's defuzzifier, sample
+         *        count and SIMD level, then publishes it. An invalid model throws and leaves the
+         *        current engine in place. Returns the engine that was replaced.
+         */
+        std::shared_ptr<const FDSHAEngine> swapModel(const FuzzyModel& model);
+    };
+
+} // namespace FDSHA
+
+#endif // ENGINEHANDLE_H
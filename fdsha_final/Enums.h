@@ -1,6 +1,8 @@
 #ifndef ENUMS_H_INCLUDED
 #define ENUMS_H_INCLUDED
 
+#include <cstddef>
+
 namespace FDSHA {
 
     // Input Variable: Maximum Magnitude (Mmax)
@@ -15,6 +17,20 @@ namespace FDSHA {
     // Output Variable: Peak Ground Acceleration (PGA)
     enum class PGATerm { VeryLow, Low, Medium, Much, VeryMuch, VeryVeryMuch };
 
+    // Number of linguistic terms per variable (sizes the enum-indexed tables)
+    constexpr std::size_t MAGNITUDE_TERM_COUNT = 5;
+    constexpr std::size_t DISTANCE_TERM_COUNT = 4;
+    constexpr std::size_t FAULT_TYPE_TERM_COUNT = 3;
+    constexpr std::size_t PGA_TERM_COUNT = 6;
+
+    /**
+     * @brief Converts a linguistic term to its position in an enum-indexed table.
+     */
+    template <typename Term>
+    constexpr std::size_t toIndex(Term t) {
+        return static_cast<std::size_t>(t);
+    }
+
 } // namespace FDSHA
 
 #endif // ENUMS_H_INCLUDED
@@ -1,190 +1,119 @@
 #include "FDSHAEngine.h"
-#include "FuzzySet.h" // Needed for the specific set implementations
+#include "FuzzySet.h"
+#include "Instrumentation.h"
 #include <algorithm>
 #include <cmath>
-#include <iostream>
-#include <sstream>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
 
 namespace FDSHA {
 
-    std::string FDSHAEngine::enumToString(MagnitudeTerm t) const {
-        switch (t) {
-            case MagnitudeTerm::Short: return "Short";
-            case MagnitudeTerm::Medium: return "Medium";
-            case MagnitudeTerm::Large: return "Large";
-            case MagnitudeTerm::VeryLarge: return "VeryLarge";
-            case MagnitudeTerm::VeryVeryLarge: return "VeryVeryLarge";
-            default: return "";
-        }
-    }
+    // Value-owned state: copies and moves are safe and cheap to reason about
+    static_assert(std::is_copy_constructible<FDSHAEngine>::value && std::is_nothrow_move_constructible<FDSHAEngine>::value,
+                  "FDSHAEngine must stay copyable and movable");
 
-    std::string FDSHAEngine::enumToString(DistanceTerm t) const {
-        switch (t) {
-            case DistanceTerm::Near: return "Near";
-            case DistanceTerm::Medium: return "Medium";
-            case DistanceTerm::Far: return "Far";
-            case DistanceTerm::VeryFar: return "VeryFar";
-            default: return "";
-        }
+    // --- Constructor ---
+    FDSHAEngine::FDSHAEngine() : FDSHAEngine(FuzzyModel::builtin()) {}
+
+    FDSHAEngine::FDSHAEngine(const FuzzyModel& model) {
+        model.validate();
+
+        // Compile the model into the flat tables the inference reads
+        MmaxSets = model.MmaxSets;
+        RSets = model.RSets;
+        FSets = model.FSets;
+        PGASets = model.PGASets;
+        Rules = model.compileRules();
+        PGAMin = model.PGAUniverse.Min;
+        PGAMax = model.PGAUniverse.Max;
+        ModelFingerprint = model.fingerprint();
+
+        MmaxPartition.build(MmaxSets);
+        RPartition.build(RSets);
+        FPartition.build(FSets);
+        buildSampleMemberships();
+        for (std::size_t term = 0; term < PGA_TERM_COUNT; ++term) PGACentroids[term] = PGASets[term].getCentroid();
     }
 
-    std::string FDSHAEngine::enumToString(FaultTypeTerm t) const {
-        switch (t) {
-            case FaultTypeTerm::Normal: return "Normal";
-            case FaultTypeTerm::Oblique: return "Oblique";
-            case FaultTypeTerm::Thrust: return "Thrust";
-            default: return "";
-        }
+    void FDSHAEngine::setSampleCount(int count) {
+        if (count < 1) throw std::invalid_argument("FDSHAEngine: sample count must be positive");
+        SampleCount = count;
+        buildSampleMemberships();
     }
 
-    std::string FDSHAEngine::enumToString(PGATerm t) const {
-        switch (t) {
-            case PGATerm::VeryLow: return "VeryLow";
-            case PGATerm::Low: return "Low";
-            case PGATerm::Medium: return "Medium";
-            case PGATerm::Much: return "Much";
-            case PGATerm::VeryMuch: return "VeryMuch";
-            case PGATerm::VeryVeryMuch: return "VeryVeryMuch";
-            default: return "";
+    namespace {
+
+        template <std::size_t TermCount>
+        bool anySetNonZero(const std::array<MembershipFunction, TermCount>& sets, double value) {
+            for (const MembershipFunction& set : sets) {
+                if (set.getMembershipDegree(value) > 0.0) return true;
+            }
+            return false;
         }
-    }
 
-    // --- Constructor and Destructor ---
-    FDSHAEngine::FDSHAEngine() {
-        initializeFuzzySets();
-        initializeRules();
-    }
+    } // namespace
 
-    FDSHAEngine::~FDSHAEngine() {
-        // Cleanup dynamically allocated memory for all fuzzy sets
-        for (auto const& [key, val] : MmaxSets) delete val;
-        for (auto const& [key, val] : RSets) delete val;
-        for (auto const& [key, val] : FSets) delete val;
-        for (auto const& [key, val] : PGASets) delete val;
+    bool FDSHAEngine::isCovered(InputAxis axis, double value) const {
+        switch (axis) {
+        case InputAxis::Magnitude: return anySetNonZero(MmaxSets, value);
+        case InputAxis::Distance: return anySetNonZero(RSets, value);
+        case InputAxis::FaultType:
+        default: return anySetNonZero(FSets, value);
+        }
     }
 
-    // --- Initialization (Fuzzy Sets) ---
-    void FDSHAEngine::initializeFuzzySets() {
-        // Note: The specific Triangular/Trapezoidal class definitions MUST be available (via FuzzySet.cpp)
-        // Mmax Sets [4.5, 8.5]
-        MmaxSets["Short"] = new TrapezoidalFuzzySet("Short", 4.5, 4.5, 5.0, 5.5);
-        MmaxSets["Medium"] = new TriangularFuzzySet("Medium", 5.0, 5.7, 6.4);
-        MmaxSets["Large"] = new TriangularFuzzySet("Large", 6.0, 6.7, 7.4);
-        MmaxSets["VeryLarge"] = new TriangularFuzzySet("VeryLarge", 7.0, 7.7, 8.1);
-        MmaxSets["VeryVeryLarge"] = new TrapezoidalFuzzySet("VeryVeryLarge", 7.8, 8.3, 8.5, 8.5);
-
-        // R Sets [0, 200] km
-        RSets["Near"] = new TrapezoidalFuzzySet("Near", 0.0, 0.0, 20.0, 40.0);
-        RSets["Medium"] = new TriangularFuzzySet("Medium", 20.0, 50.0, 80.0);
-        RSets["Far"] = new TriangularFuzzySet("Far", 60.0, 100.0, 140.0);
-        RSets["VeryFar"] = new TrapezoidalFuzzySet("VeryFar", 120.0, 160.0, 200.0, 200.0);
-
-        // F Sets [-0.1, 0.1] (Simplified Fault Index)
-        FSets["Normal"] = new TrapezoidalFuzzySet("Normal", -0.1, -0.1, -0.05, 0.0);
-        FSets["Oblique"] = new TriangularFuzzySet("Oblique", -0.05, 0.0, 0.05);
-        FSets["Thrust"] = new TrapezoidalFuzzySet("Thrust", 0.0, 0.05, 0.1, 0.1);
-
-        // PGA Sets [0, 0.9]g
-        PGASets["VeryLow"] = new TrapezoidalFuzzySet("VeryLow", 0.0, 0.0, 0.05, 0.15);
-        PGASets["Low"] = new TriangularFuzzySet("Low", 0.05, 0.15, 0.25);
-        PGASets["Medium"] = new TriangularFuzzySet("Medium", 0.15, 0.30, 0.45);
-        PGASets["Much"] = new TriangularFuzzySet("Much", 0.35, 0.50, 0.65);
-        PGASets["VeryMuch"] = new TriangularFuzzySet("VeryMuch", 0.55, 0.70, 0.85);
-        PGASets["VeryVeryMuch"] = new TrapezoidalFuzzySet("VeryVeryMuch", 0.75, 0.85, 0.9, 0.9);
+    // Tabulates the PGA sets at the sampled COG's points; the sets do not depend on the inputs.
+    void FDSHAEngine::buildSampleMemberships() {
+        const double STEP_SIZE = (PGAMax - PGAMin) / SampleCount;
+        SampleMemberships.assign(static_cast<std::size_t>(SampleCount + 1) * PGA_TERM_COUNT, 0.0);
+        for (int i = 0; i <= SampleCount; ++i) {
+            double x = PGAMin + i * STEP_SIZE;
+            for (std::size_t term = 0; term < PGA_TERM_COUNT; ++term) {
+                SampleMemberships[static_cast<std::size_t>(i) * PGA_TERM_COUNT + term] = PGASets[term].getMembershipDegree(x);
+            }
+        }
     }
 
-    // --- Rule Base (60 Rules) ---
-    void FDSHAEngine::initializeRules() {
-        // Total: 60 Rules (3 Fault Types * 4 Distances * 5 Magnitudes)
-        // ... (Rule definitions as before)
-        // I. IF Fault Type (F) is NORMAL
-        Rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::Near, FaultTypeTerm::Normal, PGATerm::Low);
-        Rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::Near, FaultTypeTerm::Normal, PGATerm::Medium);
-        Rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::Near, FaultTypeTerm::Normal, PGATerm::Much);
-        Rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::Near, FaultTypeTerm::Normal, PGATerm::VeryMuch);
-        Rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::Near, FaultTypeTerm::Normal, PGATerm::VeryMuch);
-        Rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::Medium, FaultTypeTerm::Normal, PGATerm::VeryLow);
-        Rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::Medium, FaultTypeTerm::Normal, PGATerm::Low);
-        Rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::Medium, FaultTypeTerm::Normal, PGATerm::Medium);
-        Rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::Medium, FaultTypeTerm::Normal, PGATerm::Much);
-        Rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::Medium, FaultTypeTerm::Normal, PGATerm::VeryMuch);
-        Rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::Far, FaultTypeTerm::Normal, PGATerm::VeryLow);
-        Rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::Far, FaultTypeTerm::Normal, PGATerm::VeryLow);
-        Rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::Far, FaultTypeTerm::Normal, PGATerm::Low);
-        Rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::Far, FaultTypeTerm::Normal, PGATerm::Medium);
-        Rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::Far, FaultTypeTerm::Normal, PGATerm::Much);
-        Rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::VeryFar, FaultTypeTerm::Normal, PGATerm::VeryLow);
-        Rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::VeryFar, FaultTypeTerm::Normal, PGATerm::VeryLow);
-        Rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::VeryFar, FaultTypeTerm::Normal, PGATerm::VeryLow);
-        Rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::VeryFar, FaultTypeTerm::Normal, PGATerm::Low);
-        Rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::VeryFar, FaultTypeTerm::Normal, PGATerm::Medium);
-
-        // II. IF Fault Type (F) is OBLIQUE
-        Rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::Near, FaultTypeTerm::Oblique, PGATerm::Medium);
-        Rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::Near, FaultTypeTerm::Oblique, PGATerm::Much);
-        Rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::Near, FaultTypeTerm::Oblique, PGATerm::VeryMuch);
-        Rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::Near, FaultTypeTerm::Oblique, PGATerm::VeryMuch);
-        Rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::Near, FaultTypeTerm::Oblique, PGATerm::VeryVeryMuch);
-        Rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::Medium, FaultTypeTerm::Oblique, PGATerm::Low);
-        Rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::Medium, FaultTypeTerm::Oblique, PGATerm::Medium);
-        Rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::Medium, FaultTypeTerm::Oblique, PGATerm::Much);
-        Rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::Medium, FaultTypeTerm::Oblique, PGATerm::VeryMuch);
-        Rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::Medium, FaultTypeTerm::Oblique, PGATerm::VeryMuch);
-        Rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::Far, FaultTypeTerm::Oblique, PGATerm::VeryLow);
-        Rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::Far, FaultTypeTerm::Oblique, PGATerm::Low);
-        Rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::Far, FaultTypeTerm::Oblique, PGATerm::Medium);
-        Rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::Far, FaultTypeTerm::Oblique, PGATerm::Much);
-        Rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::Far, FaultTypeTerm::Oblique, PGATerm::VeryMuch);
-        Rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::VeryFar, FaultTypeTerm::Oblique, PGATerm::VeryLow);
-        Rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::VeryFar, FaultTypeTerm::Oblique, PGATerm::VeryLow);
-        Rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::VeryFar, FaultTypeTerm::Oblique, PGATerm::Low);
-        Rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::VeryFar, FaultTypeTerm::Oblique, PGATerm::Medium);
-        Rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::VeryFar, FaultTypeTerm::Oblique, PGATerm::Much);
-
-        // III. IF Fault Type (F) is THRUST
-        Rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::Near, FaultTypeTerm::Thrust, PGATerm::Much);
-        Rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::Near, FaultTypeTerm::Thrust, PGATerm::VeryMuch);
-        Rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::Near, FaultTypeTerm::Thrust, PGATerm::VeryVeryMuch);
-        Rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::Near, FaultTypeTerm::Thrust, PGATerm::VeryVeryMuch);
-        Rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::Near, FaultTypeTerm::Thrust, PGATerm::VeryVeryMuch);
-        Rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::Medium, FaultTypeTerm::Thrust, PGATerm::Medium);
-        Rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::Medium, FaultTypeTerm::Thrust, PGATerm::Much);
-        Rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::Medium, FaultTypeTerm::Thrust, PGATerm::VeryMuch);
-        Rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::Medium, FaultTypeTerm::Thrust, PGATerm::VeryMuch);
-        Rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::Medium, FaultTypeTerm::Thrust, PGATerm::VeryVeryMuch);
-        Rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::Far, FaultTypeTerm::Thrust, PGATerm::Low);
-        Rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::Far, FaultTypeTerm::Thrust, PGATerm::Medium);
-        Rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::Far, FaultTypeTerm::Thrust, PGATerm::Much);
-        Rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::Far, FaultTypeTerm::Thrust, PGATerm::VeryMuch);
-        Rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::Far, FaultTypeTerm::Thrust, PGATerm::VeryMuch);
-        Rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::VeryFar, FaultTypeTerm::Thrust, PGATerm::VeryLow);
-        Rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::VeryFar, FaultTypeTerm::Thrust, PGATerm::Low);
-        Rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::VeryFar, FaultTypeTerm::Thrust, PGATerm::Medium);
-        Rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::VeryFar, FaultTypeTerm::Thrust, PGATerm::Much);
-        Rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::VeryFar, FaultTypeTerm::Thrust, PGATerm::VeryMuch);
+    // --- Defuzzification ---
+    double FDSHAEngine::defuzzify(const PGAStrengths& aggregatedConsequents) const {
+        if (Defuzzification == DefuzzificationMethod::ExactCenterOfGravity) {
+            return defuzzifyExactCenterOfGravity(aggregatedConsequents);
+        }
+        return defuzzifyCenterOfGravity(aggregatedConsequents);
     }
 
-    // --- Defuzzification (Center of Gravity) ---
-    double FDSHAEngine::defuzzifyCenterOfGravity(const std::map<PGATerm, double>& aggregatedConsequents) const {
-        // Output Universe of Discourse: PGA [0.0g, 0.9g]
-        const double PGA_MIN = 0.0;
-        const double PGA_MAX = 0.9;
-        const int NUM_POINTS = 1000;
-        const double STEP_SIZE = (PGA_MAX - PGA_MIN) / NUM_POINTS;
+    // --- Defuzzification (Center of Gravity, sampled) ---
+    double FDSHAEngine::defuzzifyCenterOfGravity(const PGAStrengths& aggregatedConsequents) const {
+        const int NUM_POINTS = SampleCount;
+        const double STEP_SIZE = (PGAMax - PGAMin) / NUM_POINTS;
+
+        // Consequents with alpha = 0 clip to nothing and cannot raise the aggregate
+        std::array<std::size_t, PGA_TERM_COUNT> activeTerms;
+        std::size_t activeCount = 0;
+        for (std::size_t term = 0; term < PGA_TERM_COUNT; ++term) {
+            if (aggregatedConsequents[term] > 0.0) activeTerms[activeCount++] = term;
+        }
+        if (activeCount == 0) {
+            FDSHA_INSTRUMENT(Instrumentation::add(Counter::Fallbacks);)
+            return (PGAMin + PGAMax) / 2.0;
+        }
 
         double numerator = 0.0;
         double denominator = 0.0;
 
         // Numerical integration using summation (for COG)
         for (int i = 0; i <= NUM_POINTS; ++i) {
-            double x = PGA_MIN + i * STEP_SIZE;
+            double x = PGAMin + i * STEP_SIZE;
+            const double* baseMemberships = &SampleMemberships[static_cast<std::size_t>(i) * PGA_TERM_COUNT];
             double aggregatedMembership = 0.0;
 
             // Compute the aggregated membership (mu_C'(x))
-            for (auto const& [term, alpha] : aggregatedConsequents) {
+            for (std::size_t k = 0; k < activeCount; ++k) {
+                std::size_t term = activeTerms[k];
                 // Clipping (Min operator)
-                double baseMembership = PGASets.at(enumToString(term))->getMembershipDegree(x);
-                double clippedMembership = std::min(baseMembership, alpha);
+                double baseMembership = baseMemberships[term];
+                double clippedMembership = std::min(baseMembership, aggregatedConsequents[term]);
                 // Aggregation (Max operator)
                 aggregatedMembership = std::max(aggregatedMembership, clippedMembership);
             }
@@ -194,42 +123,581 @@ namespace FDSHA {
             denominator += aggregatedMembership;
         }
 
-        if (denominator == 0.0) return (PGA_MIN + PGA_MAX) / 2.0;
+        if (denominator == 0.0) {
+            FDSHA_INSTRUMENT(Instrumentation::add(Counter::Fallbacks);)
+            return (PGAMin + PGAMax) / 2.0;
+        }
         return numerator / denominator;
     }
 
-    // --- Core Inference Process ---
-    double FDSHAEngine::findPGA(double mmaxInput, double rInput, double fInput) {
-        // 1. FUZZIFICATION
-        std::map<std::string, double> mmaxMemberships;
-        for (auto const& [name, set] : MmaxSets) mmaxMemberships[name] = set->getMembershipDegree(mmaxInput);
+    // --- Defuzzification (Center of Gravity, exact) ---
+    double FDSHAEngine::defuzzifyExactCenterOfGravity(const PGAStrengths& aggregatedConsequents) const {
+        // Every clipped consequent is piecewise linear, so the aggregated set is linear between
+        // the set breakpoints, the alpha-cut points and the crossings of any two slopes.
+        // Collecting all of them and integrating each linear piece gives the exact centroid.
+        constexpr std::size_t SLOPE_COUNT = 2 * PGA_TERM_COUNT;
+        constexpr std::size_t MAX_POINTS = 2 + 4 * PGA_TERM_COUNT + PGA_TERM_COUNT * SLOPE_COUNT
+                                         + SLOPE_COUNT * (SLOPE_COUNT - 1) / 2;
+        std::array<double, MAX_POINTS> points;
+        std::size_t pointCount = 0;
+        auto addPoint = [&](double x) {
+            if (x > PGAMin && x < PGAMax) points[pointCount++] = x;
+        };
+
+        // Only consequents that actually fired contribute to the aggregated set
+        std::array<std::size_t, PGA_TERM_COUNT> activeTerms;
+        std::size_t activeCount = 0;
+        for (std::size_t term = 0; term < PGA_TERM_COUNT; ++term) {
+            if (aggregatedConsequents[term] > 0.0) activeTerms[activeCount++] = term;
+        }
+        if (activeCount == 0) {
+            FDSHA_INSTRUMENT(Instrumentation::add(Counter::Fallbacks);)
+            return (PGAMin + PGAMax) / 2.0;
+        }
+
+        // Slopes as lines y = slope * x + intercept
+        std::array<double, SLOPE_COUNT> slopes;
+        std::array<double, SLOPE_COUNT> intercepts;
+        std::size_t slopeCount = 0;
+
+        points[pointCount++] = PGAMin;
+        points[pointCount++] = PGAMax;
+        for (std::size_t k = 0; k < activeCount; ++k) {
+            const MembershipFunction& set = PGASets[activeTerms[k]];
+            addPoint(set.a);
+            addPoint(set.b);
+            addPoint(set.c);
+            addPoint(set.d);
+            if (set.b > set.a) {
+                slopes[slopeCount] = 1.0 / (set.b - set.a);
+                intercepts[slopeCount++] = -set.a / (set.b - set.a);
+            }
+            if (set.d > set.c) {
+                slopes[slopeCount] = -1.0 / (set.d - set.c);
+                intercepts[slopeCount++] = set.d / (set.d - set.c);
+            }
+        }
+
+        // Alpha-cut points: where any slope reaches any clipping level
+        for (std::size_t k = 0; k < activeCount; ++k) {
+            double alpha = aggregatedConsequents[activeTerms[k]];
+            for (std::size_t i = 0; i < slopeCount; ++i) addPoint((alpha - intercepts[i]) / slopes[i]);
+        }
 
-        std::map<std::string, double> rMemberships;
-        for (auto const& [name, set] : RSets) rMemberships[name] = set->getMembershipDegree(rInput);
+        // Crossings of two slopes
+        for (std::size_t i = 0; i < slopeCount; ++i) {
+            for (std::size_t j = i + 1; j < slopeCount; ++j) {
+                if (slopes[i] != slopes[j]) addPoint((intercepts[j] - intercepts[i]) / (slopes[i] - slopes[j]));
+            }
+        }
+
+        std::sort(points.begin(), points.begin() + pointCount);
+        pointCount = static_cast<std::size_t>(std::unique(points.begin(), points.begin() + pointCount) - points.begin());
+
+        auto aggregatedMembership = [&](double x) {
+            double membership = 0.0;
+            for (std::size_t k = 0; k < activeCount; ++k) {
+                std::size_t term = activeTerms[k];
+                double clipped = std::min(PGASets[term].getMembershipDegree(x), aggregatedConsequents[term]);
+                membership = std::max(membership, clipped);
+            }
+            return membership;
+        };
+
+        double area = 0.0;
+        double moment = 0.0;
+        for (std::size_t i = 0; i + 1 < pointCount; ++i) {
+            double width = points[i + 1] - points[i];
+            if (width <= 0.0) continue;
+            // Sample the interior so a jump at a breakpoint (e.g. a shoulder) does not leak in
+            double xMid = points[i] + 0.5 * width;
+            double yLeft = aggregatedMembership(points[i] + 0.25 * width);
+            double yRight = aggregatedMembership(points[i] + 0.75 * width);
+            double yMid = 0.5 * (yLeft + yRight);
+            double slope = (yRight - yLeft) / (0.5 * width);
+
+            // Integral of y and x*y over a linear piece
+            area += width * yMid;
+            moment += width * (xMid * yMid + slope * width * width / 12.0);
+        }
 
-        std::map<std::string, double> fMemberships;
-        for (auto const& [name, set] : FSets) fMemberships[name] = set->getMembershipDegree(fInput);
+        if (area <= 0.0) {
+            FDSHA_INSTRUMENT(Instrumentation::add(Counter::Fallbacks);)
+            return (PGAMin + PGAMax) / 2.0;
+        }
+        return moment / area;
+    }
+
+    // --- Core Inference Process ---
+    // 1. FUZZIFICATION (only the terms that can be non-zero for these inputs)
+    FuzzifiedInputs FDSHAEngine::fuzzify(double mmaxInput, double rInput, double fInput) const {
+        FuzzifiedInputs inputs;
+        inputs.Mmax.Active = &MmaxPartition.find(mmaxInput);
+        inputs.R.Active = &RPartition.find(rInput);
+        inputs.F.Active = &FPartition.find(fInput);
 
-        // 2. INFERENCE & AGGREGATION (Max-Min)
-        std::map<PGATerm, double> aggregatedConsequents;
+        for (std::size_t i = 0; i < inputs.Mmax.Active->Count; ++i) {
+            inputs.Mmax.Degrees[i] = MmaxSets[inputs.Mmax.Active->Terms[i]].getMembershipDegree(mmaxInput);
+        }
+        for (std::size_t i = 0; i < inputs.R.Active->Count; ++i) {
+            inputs.R.Degrees[i] = RSets[inputs.R.Active->Terms[i]].getMembershipDegree(rInput);
+        }
+        for (std::size_t i = 0; i < inputs.F.Active->Count; ++i) {
+            inputs.F.Degrees[i] = FSets[inputs.F.Active->Terms[i]].getMembershipDegree(fInput);
+        }
+        return inputs;
+    }
 
-        for (const auto& rule : Rules) {
-            // Retrieve degrees
-            double mmaxDeg = mmaxMemberships.at(enumToString(rule.Mmax));
-            double rDeg = rMemberships.at(enumToString(rule.R));
-            double fDeg = fMemberships.at(enumToString(rule.F));
+    // 2. INFERENCE & AGGREGATION (Max-Min) over the rules that can fire; every other rule has alpha = 0
+    PGAStrengths FDSHAEngine::infer(const FuzzifiedInputs& inputs) const {
+        const ActiveTerms<MAGNITUDE_TERM_COUNT>& mmaxTerms = *inputs.Mmax.Active;
+        const ActiveTerms<DISTANCE_TERM_COUNT>& rTerms = *inputs.R.Active;
+        const ActiveTerms<FAULT_TYPE_TERM_COUNT>& fTerms = *inputs.F.Active;
+        PGAStrengths aggregatedConsequents{};
+        FDSHA_INSTRUMENT(std::uint64_t firedRules = 0;)
 
-            // Calculate firing strength (alpha)
-            double alpha = rule.getFiringStrength(mmaxDeg, rDeg, fDeg);
-            PGATerm term = rule.PGA;
+        for (std::size_t m = 0; m < mmaxTerms.Count; ++m) {
+            for (std::size_t r = 0; r < rTerms.Count; ++r) {
+                for (std::size_t f = 0; f < fTerms.Count; ++f) {
+                    // Calculate firing strength (alpha)
+                    double alpha = FuzzyRule::getFiringStrength(inputs.Mmax.Degrees[m], inputs.R.Degrees[r], inputs.F.Degrees[f]);
+                    std::size_t term = toIndex(Rules[ruleIndex(mmaxTerms.Terms[m], rTerms.Terms[r], fTerms.Terms[f])]);
+                    FDSHA_INSTRUMENT(firedRules += alpha > 0.0;)
 
-            // Aggregation (MAX)
-            if (aggregatedConsequents.find(term) == aggregatedConsequents.end() || alpha > aggregatedConsequents[term]) {
-                aggregatedConsequents[term] = alpha;
+                    // Aggregation (MAX)
+                    aggregatedConsequents[term] = std::max(aggregatedConsequents[term], alpha);
+                }
             }
         }
+        FDSHA_INSTRUMENT(Instrumentation::add(Counter::FiredRules, firedRules);)
+        return aggregatedConsequents;
+    }
+
+    double FDSHAEngine::findPGA(double mmaxInput, double rInput, double fInput) const {
+#ifdef FDSHA_ENABLE_INSTRUMENTATION
+        // The same pipeline with every stage timed
+        Instrumentation::StageClock clock;
+        FuzzifiedInputs inputs = fuzzify(mmaxInput, rInput, fInput);
+        clock.lap(Counter::FuzzifyNanoseconds);
+        PGAStrengths aggregatedConsequents = infer(inputs);
+        clock.lap(Counter::InferNanoseconds);
+        double pga = defuzzify(aggregatedConsequents);
+        clock.lap(Counter::DefuzzifyNanoseconds);
 
+        Instrumentation::recordCall(clock.total());
+        if (inputs.Mmax.Active->Count == 0) Instrumentation::add(Counter::MmaxOutOfUniverse);
+        if (inputs.R.Active->Count == 0) Instrumentation::add(Counter::ROutOfUniverse);
+        if (inputs.F.Active->Count == 0) Instrumentation::add(Counter::FOutOfUniverse);
+        return pga;
+#else
         // 3. DEFUZZIFICATION
-        return defuzzifyCenterOfGravity(aggregatedConsequents);
+        return defuzzify(infer(fuzzify(mmaxInput, rInput, fInput)));
+#endif
     }
+
+    // --- Batch Inference Process ---
+#ifdef FDSHA_ENABLE_INSTRUMENTATION
+    namespace {
+
+        // Lanes of a block that fall outside every term of the partition
+        template <std::size_t TermCount>
+        std::uint64_t countOutOfUniverse(const TermPartition<TermCount>& partition, const double* inputs, std::size_t n) {
+            std::uint64_t outside = 0;
+            for (std::size_t lane = 0; lane < n; ++lane) outside += partition.locate(inputs[lane]) < 0;
+            return outside;
+        }
+
+    } // namespace
+#endif
+
+    void FDSHAEngine::findPGABatch(const double* mmaxInputs, const double* rInputs, const double* fInputs,
+                                   double* pgaOutputs, std::size_t count) const {
+        // Lanes are processed in fixed blocks so every intermediate lives on the stack
+        constexpr std::size_t BLOCK_SIZE = 64;
+        std::array<double, MAGNITUDE_TERM_COUNT * BLOCK_SIZE> mmaxMemberships;
+        std::array<double, DISTANCE_TERM_COUNT * BLOCK_SIZE> rMemberships;
+        std::array<double, FAULT_TYPE_TERM_COUNT * BLOCK_SIZE> fMemberships;
+        std::array<double, PGA_TERM_COUNT * BLOCK_SIZE> aggregatedConsequents;
+
+        const BatchKernels& kernels = getBatchKernels(BatchSimdLevel);
+        const double STEP_SIZE = (PGAMax - PGAMin) / SampleCount;
+        FDSHA_INSTRUMENT(Instrumentation::StageClock clock;)
+
+        for (std::size_t start = 0; start < count; start += BLOCK_SIZE) {
+            std::size_t n = std::min(BLOCK_SIZE, count - start);
+            FDSHA_INSTRUMENT(
+                Instrumentation::add(Counter::MmaxOutOfUniverse, countOutOfUniverse(MmaxPartition, mmaxInputs + start, n));
+                Instrumentation::add(Counter::ROutOfUniverse, countOutOfUniverse(RPartition, rInputs + start, n));
+                Instrumentation::add(Counter::FOutOfUniverse, countOutOfUniverse(FPartition, fInputs + start, n));
+            )
+
+            // 1. FUZZIFICATION
+            for (std::size_t i = 0; i < MAGNITUDE_TERM_COUNT; ++i) kernels.fuzzify(MmaxSets[i], mmaxInputs + start, &mmaxMemberships[i * n], n);
+            for (std::size_t i = 0; i < DISTANCE_TERM_COUNT; ++i) kernels.fuzzify(RSets[i], rInputs + start, &rMemberships[i * n], n);
+            for (std::size_t i = 0; i < FAULT_TYPE_TERM_COUNT; ++i) kernels.fuzzify(FSets[i], fInputs + start, &fMemberships[i * n], n);
+
+            // 2. INFERENCE & AGGREGATION (Max-Min)
+            kernels.infer(mmaxMemberships.data(), rMemberships.data(), fMemberships.data(), Rules.data(),
+                          aggregatedConsequents.data(), n);
+
+            // 3. DEFUZZIFICATION
+            if (Defuzzification == DefuzzificationMethod::SampledCenterOfGravity) {
+                kernels.defuzzifySampled(aggregatedConsequents.data(), SampleMemberships.data(), SampleCount,
+                                         PGAMin, STEP_SIZE, (PGAMin + PGAMax) / 2.0, pgaOutputs + start, n);
+                // The kernel falls back to the midpoint for lanes where nothing fired
+                FDSHA_INSTRUMENT(
+                    std::uint64_t fallbacks = 0;
+                    for (std::size_t lane = 0; lane < n; ++lane) {
+                        bool fired = false;
+                        for (std::size_t term = 0; term < PGA_TERM_COUNT; ++term) fired |= aggregatedConsequents[term * n + lane] > 0.0;
+                        fallbacks += !fired;
+                    }
+                    Instrumentation::add(Counter::Fallbacks, fallbacks);
+                )
+            } else {
+                for (std::size_t lane = 0; lane < n; ++lane) {
+                    PGAStrengths strengths;
+                    for (std::size_t term = 0; term < PGA_TERM_COUNT; ++term) strengths[term] = aggregatedConsequents[term * n + lane];
+                    pgaOutputs[start + lane] = defuzzify(strengths);
+                }
+            }
+        }
+
+        FDSHA_INSTRUMENT(
+            clock.lap(Counter::BatchNanoseconds);
+            Instrumentation::add(Counter::BatchCalls);
+            Instrumentation::add(Counter::BatchRows, count);
+        )
+    }
+
+    // --- One-Axis Sweeps ---
+    namespace {
+
+        // Strongest fixed-input rule strength per consequent, for each term of the swept axis
+        using TermCeilings = std::array<PGAStrengths, std::max({MAGNITUDE_TERM_COUNT, DISTANCE_TERM_COUNT, FAULT_TYPE_TERM_COUNT})>;
+
+        /**
+         * @brief Walks the swept axis and hands the aggregated consequents of every point to emit.
+         */
+        template <std::size_t TermCount, typename Emit>
+        void sweepAxis(const TermPartition<TermCount>& partition, const std::array<MembershipFunction, TermCount>& sets,
+                       const TermCeilings& ceilings, const double* axisValues, std::size_t count, Emit&& emit) {
+            const std::vector<double>& breakpoints = partition.getBreakpoints();
+            std::ptrdiff_t interval = -1;
+
+            for (std::size_t i = 0; i < count; ++i) {
+                double x = axisValues[i];
+
+                // Stay in (or step to the next) interval while the values increase; search otherwise
+                if (interval >= 0 && !(x >= breakpoints[interval] && x < breakpoints[interval + 1])) {
+                    std::size_t next = static_cast<std::size_t>(interval) + 1;
+                    if (next + 1 < breakpoints.size() && x >= breakpoints[next] && x < breakpoints[next + 1]) {
+                        interval = static_cast<std::ptrdiff_t>(next);
+                    } else {
+                        interval = -1;
+                    }
+                }
+                if (interval < 0) interval = partition.locate(x);
+
+                PGAStrengths aggregatedConsequents{};
+                if (interval >= 0) {
+                    const ActiveTerms<TermCount>& active = partition.getInterval(static_cast<std::size_t>(interval));
+                    for (std::size_t k = 0; k < active.Count; ++k) {
+                        std::size_t term = active.Terms[k];
+                        double degree = sets[term].getMembershipDegree(x);
+                        for (std::size_t t = 0; t < PGA_TERM_COUNT; ++t) {
+                            aggregatedConsequents[t] = std::max(aggregatedConsequents[t], std::min(degree, ceilings[term][t]));
+                        }
+                    }
+                }
+                emit(i, aggregatedConsequents);
+            }
+        }
+
+    } // namespace
+
+    void FDSHAEngine::findPGASweep(InputAxis axis, double mmaxInput, double rInput, double fInput, const double* axisValues,
+                                   double* pgaOutputs, std::size_t count) const {
+        // 1. FUZZIFICATION of the fixed inputs, once
+        const double NONE = std::numeric_limits<double>::quiet_NaN();
+        FuzzifiedInputs fixed = fuzzify(axis == InputAxis::Magnitude ? NONE : mmaxInput,
+                                        axis == InputAxis::Distance ? NONE : rInput,
+                                        axis == InputAxis::FaultType ? NONE : fInput);
+
+        // 2. INFERENCE over the fixed inputs: min over the two fixed degrees, max per consequent.
+        //    A point then only takes min(its own degree, ceiling) for each active swept term.
+        TermCeilings ceilings{};
+        auto fold = [&](std::size_t sweptTerm, std::size_t mmax, std::size_t r, std::size_t f, double fixedStrength) {
+            std::size_t term = toIndex(Rules[ruleIndex(mmax, r, f)]);
+            ceilings[sweptTerm][term] = std::max(ceilings[sweptTerm][term], fixedStrength);
+        };
+        switch (axis) {
+        case InputAxis::Magnitude:
+            for (std::size_t m = 0; m < MAGNITUDE_TERM_COUNT; ++m)
+                for (std::size_t r = 0; r < fixed.R.Active->Count; ++r)
+                    for (std::size_t f = 0; f < fixed.F.Active->Count; ++f)
+                        fold(m, m, fixed.R.Active->Terms[r], fixed.F.Active->Terms[f], std::min(fixed.R.Degrees[r], fixed.F.Degrees[f]));
+            break;
+        case InputAxis::Distance:
+            for (std::size_t r = 0; r < DISTANCE_TERM_COUNT; ++r)
+                for (std::size_t m = 0; m < fixed.Mmax.Active->Count; ++m)
+                    for (std::size_t f = 0; f < fixed.F.Active->Count; ++f)
+                        fold(r, fixed.Mmax.Active->Terms[m], r, fixed.F.Active->Terms[f], std::min(fixed.Mmax.Degrees[m], fixed.F.Degrees[f]));
+            break;
+        case InputAxis::FaultType:
+            for (std::size_t f = 0; f < FAULT_TYPE_TERM_COUNT; ++f)
+                for (std::size_t m = 0; m < fixed.Mmax.Active->Count; ++m)
+                    for (std::size_t r = 0; r < fixed.R.Active->Count; ++r)
+                        fold(f, fixed.Mmax.Active->Terms[m], fixed.R.Active->Terms[r], f, std::min(fixed.Mmax.Degrees[m], fixed.R.Degrees[r]));
+            break;
+        }
+
+        // 3. DEFUZZIFICATION in blocks of distinct rule strengths; a run of equal strengths shares one lane
+        constexpr std::size_t BLOCK_SIZE = 64;
+        std::array<double, PGA_TERM_COUNT * BLOCK_SIZE> blockConsequents;
+        std::array<double, BLOCK_SIZE> blockOutputs;
+        std::array<std::size_t, BLOCK_SIZE + 1> laneStart;   // lane l covers outputs [laneStart[l], laneStart[l + 1])
+        std::size_t lanes = 0;
+        PGAStrengths previous{};
+        double previousPGA = 0.0;
+        bool havePrevious = false;
+
+        const BatchKernels& kernels = getBatchKernels(BatchSimdLevel);
+        const double STEP_SIZE = (PGAMax - PGAMin) / SampleCount;
+
+        auto flush = [&](std::size_t end) {
+            if (lanes == 0) return;
+            laneStart[lanes] = end;
+            if (Defuzzification == DefuzzificationMethod::SampledCenterOfGravity) {
+                // Compact the term-major rows to a stride of lanes for the kernel
+                for (std::size_t t = 1; t < PGA_TERM_COUNT; ++t) {
+                    std::copy_n(&blockConsequents[t * BLOCK_SIZE], lanes, &blockConsequents[t * lanes]);
+                }
+                kernels.defuzzifySampled(blockConsequents.data(), SampleMemberships.data(), SampleCount,
+                                         PGAMin, STEP_SIZE, (PGAMin + PGAMax) / 2.0, blockOutputs.data(), lanes);
+            } else {
+                for (std::size_t lane = 0; lane < lanes; ++lane) {
+                    PGAStrengths strengths;
+                    for (std::size_t t = 0; t < PGA_TERM_COUNT; ++t) strengths[t] = blockConsequents[t * BLOCK_SIZE + lane];
+                    blockOutputs[lane] = defuzzify(strengths);
+                }
+            }
+            for (std::size_t lane = 0; lane < lanes; ++lane) {
+                std::fill(pgaOutputs + laneStart[lane], pgaOutputs + laneStart[lane + 1], blockOutputs[lane]);
+            }
+            previousPGA = blockOutputs[lanes - 1];
+            lanes = 0;
+        };
+
+        auto emit = [&](std::size_t i, const PGAStrengths& aggregatedConsequents) {
+            if (havePrevious && aggregatedConsequents == previous) {
+                // Same strengths as the point before: extend its lane, or copy its settled PGA
+                if (lanes == 0) pgaOutputs[i] = previousPGA;
+                return;
+            }
+            if (lanes == BLOCK_SIZE) flush(i);
+            laneStart[lanes] = i;
+            for (std::size_t t = 0; t < PGA_TERM_COUNT; ++t) blockConsequents[t * BLOCK_SIZE + lanes] = aggregatedConsequents[t];
+            ++lanes;
+            previous = aggregatedConsequents;
+            havePrevious = true;
+        };
+
+        switch (axis) {
+        case InputAxis::Magnitude: sweepAxis(MmaxPartition, MmaxSets, ceilings, axisValues, count, emit); break;
+        case InputAxis::Distance: sweepAxis(RPartition, RSets, ceilings, axisValues, count, emit); break;
+        case InputAxis::FaultType: sweepAxis(FPartition, FSets, ceilings, axisValues, count, emit); break;
+        }
+        flush(count);
+    }
+
+    // --- Inverse Queries ---
+    namespace {
+
+        // A pending crossing between two neighbouring probes of one query
+        struct Bracket {
+            std::size_t Query;
+            std::size_t Probe;  // the crossing lies between probes Probe and Probe + 1
+            double Inside;      // end on the exceeding side
+            double Outside;
+        };
+
+        /**
+         * @brief Appends the probe points of one axis: the ends and midpoints of every piece on
+         *        which all rule strengths are linear. levels are the fixed inputs' degrees.
+         */
+        template <std::size_t TermCount>
+        void appendAxisProbes(const TermPartition<TermCount>& partition, const std::array<MembershipFunction, TermCount>& sets,
+                              const double* levels, std::size_t levelCount, std::vector<double>& probes) {
+            const std::vector<double>& breakpoints = partition.getBreakpoints();
+            std::size_t first = probes.size();
+            std::vector<double> cuts;
+
+            for (std::size_t i = 0; i < partition.getIntervalCount(); ++i) {
+                double lo = breakpoints[i];
+                double hi = breakpoints[i + 1];
+                double mid = 0.5 * (lo + hi);
+
+                // Degree of each active term as a line y = slope * x + intercept on [lo, hi]
+                const ActiveTerms<TermCount>& active = partition.getInterval(i);
+                std::array<double, TermCount> slopes;
+                std::array<double, TermCount> intercepts;
+                for (std::size_t k = 0; k < active.Count; ++k) {
+                    const MembershipFunction& set = sets[active.Terms[k]];
+                    if (mid < set.b) {
+                        slopes[k] = 1.0 / (set.b - set.a);
+                        intercepts[k] = -set.a / (set.b - set.a);
+                    } else if (mid <= set.c) {
+                        slopes[k] = 0.0;
+                        intercepts[k] = 1.0;
+                    } else {
+                        slopes[k] = -1.0 / (set.d - set.c);
+                        intercepts[k] = set.d / (set.d - set.c);
+                    }
+                }
+
+                cuts.assign(1, lo);
+                auto addCut = [&](double x) {
+                    if (x > lo && x < hi) cuts.push_back(x);
+                };
+                for (std::size_t k = 0; k < active.Count; ++k) {
+                    if (slopes[k] == 0.0) continue;
+                    for (std::size_t j = k + 1; j < active.Count; ++j) {
+                        if (slopes[j] != slopes[k]) addCut((intercepts[j] - intercepts[k]) / (slopes[k] - slopes[j]));
+                    }
+                    for (std::size_t l = 0; l < levelCount; ++l) addCut((levels[l] - intercepts[k]) / slopes[k]);
+                }
+                std::sort(cuts.begin(), cuts.end());
+                cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+                cuts.push_back(hi);
+
+                for (std::size_t j = 0; j + 1 < cuts.size(); ++j) {
+                    probes.push_back(cuts[j]);
+                    probes.push_back(0.5 * (cuts[j] + cuts[j + 1]));
+                }
+            }
+            if (breakpoints.empty()) return;
+            probes.push_back(breakpoints.back());
+
+            // Every set is zero on the universe ends themselves; probe just inside them
+            probes[first] = std::nextafter(breakpoints.front(), breakpoints.back());
+            probes.back() = std::nextafter(breakpoints.back(), breakpoints.front());
+        }
+
+        // Fixed-input degrees of a fuzzified variable
+        template <std::size_t TermCount>
+        void appendLevels(const FuzzifiedVariable<TermCount>& variable, std::vector<double>& levels) {
+            levels.insert(levels.end(), variable.Degrees.begin(), variable.Degrees.begin() + variable.Active->Count);
+        }
+
+    } // namespace
+
+    ExceedanceIntervals FDSHAEngine::findExceedanceIntervals(InputAxis axis, double threshold, double mmaxInput, double rInput,
+                                                             double fInput, double tolerance) const {
+        ExceedanceIntervals result;
+        findExceedanceIntervalsBatch(axis, threshold, &mmaxInput, &rInput, &fInput, &result, 1, tolerance);
+        return result;
+    }
+
+    void FDSHAEngine::findExceedanceIntervalsBatch(InputAxis axis, double threshold, const double* mmaxInputs, const double* rInputs,
+                                                   const double* fInputs, ExceedanceIntervals* results, std::size_t count,
+                                                   double tolerance) const {
+        if (!(tolerance > 0.0)) throw std::invalid_argument("FDSHAEngine: inverse query tolerance must be positive");
+
+        // Inputs of query q with the varied axis set to x
+        const double* inputs[3] = {mmaxInputs, rInputs, fInputs};
+        const std::size_t varied = static_cast<std::size_t>(axis);
+        auto fill = [&](std::size_t q, double x, double& mmax, double& r, double& f) {
+            double* values[3] = {&mmax, &r, &f};
+            for (std::size_t v = 0; v < 3; ++v) *values[v] = v == varied ? x : inputs[v][q];
+        };
+
+        // 1. PROBES: piece ends and midpoints for every query, evaluated in one batch
+        std::vector<double> probes;
+        std::vector<std::size_t> probeStart(count + 1, 0);
+        std::vector<double> levels;
+        for (std::size_t q = 0; q < count; ++q) {
+            double mmax, r, f;
+            fill(q, std::numeric_limits<double>::quiet_NaN(), mmax, r, f);
+            FuzzifiedInputs fixed = fuzzify(mmax, r, f);
+            levels.clear();
+            if (axis != InputAxis::Magnitude) appendLevels(fixed.Mmax, levels);
+            if (axis != InputAxis::Distance) appendLevels(fixed.R, levels);
+            if (axis != InputAxis::FaultType) appendLevels(fixed.F, levels);
+
+            switch (axis) {
+            case InputAxis::Magnitude: appendAxisProbes(MmaxPartition, MmaxSets, levels.data(), levels.size(), probes); break;
+            case InputAxis::Distance: appendAxisProbes(RPartition, RSets, levels.data(), levels.size(), probes); break;
+            case InputAxis::FaultType: appendAxisProbes(FPartition, FSets, levels.data(), levels.size(), probes); break;
+            }
+            probeStart[q + 1] = probes.size();
+            results[q].Intervals.clear();
+            results[q].Evaluations = probeStart[q + 1] - probeStart[q];
+        }
+
+        std::vector<double> mmaxBuffer(probes.size()), rBuffer(probes.size()), fBuffer(probes.size()), pga(probes.size());
+        for (std::size_t q = 0; q < count; ++q) {
+            for (std::size_t i = probeStart[q]; i < probeStart[q + 1]; ++i) fill(q, probes[i], mmaxBuffer[i], rBuffer[i], fBuffer[i]);
+        }
+        findPGABatch(mmaxBuffer.data(), rBuffer.data(), fBuffer.data(), pga.data(), probes.size());
+        std::vector<char> exceeds(probes.size());
+        for (std::size_t i = 0; i < probes.size(); ++i) exceeds[i] = pga[i] >= threshold;
+
+        // 2. BISECTION of every side change, all queries in lockstep
+        std::vector<Bracket> brackets;
+        for (std::size_t q = 0; q < count; ++q) {
+            for (std::size_t i = probeStart[q]; i + 1 < probeStart[q + 1]; ++i) {
+                if (exceeds[i] == exceeds[i + 1]) continue;
+                brackets.push_back({q, i, exceeds[i] ? probes[i] : probes[i + 1], exceeds[i] ? probes[i + 1] : probes[i]});
+            }
+        }
+
+        std::vector<std::size_t> open;
+        for (;;) {
+            open.clear();
+            for (std::size_t b = 0; b < brackets.size(); ++b) {
+                if (std::fabs(brackets[b].Inside - brackets[b].Outside) > tolerance) open.push_back(b);
+            }
+            if (open.empty()) break;
+
+            for (std::size_t k = 0; k < open.size(); ++k) {
+                const Bracket& bracket = brackets[open[k]];
+                fill(bracket.Query, 0.5 * (bracket.Inside + bracket.Outside), mmaxBuffer[k], rBuffer[k], fBuffer[k]);
+            }
+            findPGABatch(mmaxBuffer.data(), rBuffer.data(), fBuffer.data(), pga.data(), open.size());
+            for (std::size_t k = 0; k < open.size(); ++k) {
+                Bracket& bracket = brackets[open[k]];
+                ++results[bracket.Query].Evaluations;
+                double mid = 0.5 * (bracket.Inside + bracket.Outside);
+                if (mid == bracket.Inside || mid == bracket.Outside) {
+                    // Adjacent doubles: the bracket cannot shrink further
+                    bracket.Outside = bracket.Inside;
+                    continue;
+                }
+                (pga[k] >= threshold ? bracket.Inside : bracket.Outside) = mid;
+            }
+        }
+
+        // 3. INTERVALS: runs of exceeding probes, closed off at the bisected crossings
+        const Universe range = axis == InputAxis::Magnitude ? getMagnitudeUniverse()
+                             : axis == InputAxis::Distance ? getDistanceUniverse() : getFaultTypeUniverse();
+        std::size_t next = 0;
+        for (std::size_t q = 0; q < count; ++q) {
+            std::size_t begin = probeStart[q];
+            std::size_t end = probeStart[q + 1];
+            if (begin == end) continue;
+            double start = range.Min;
+            bool inside = exceeds[begin];
+            for (; next < brackets.size() && brackets[next].Query == q; ++next) {
+                if (!inside) {
+                    start = brackets[next].Inside;
+                } else {
+                    results[q].Intervals.push_back({start, brackets[next].Inside});
+                }
+                inside = !inside;
+            }
+            if (inside) results[q].Intervals.push_back({start, range.Max});
+        }
+    }
+
 } // namespace FDSHA
@@ -4,47 +4,302 @@
 #include "Enums.h"
 #include "FuzzySet.h"
 #include "FuzzyRule.h"
-#include <map>
+#include "FuzzyModel.h"
+#include "BatchKernels.h"
+#include "InferencePolicies.h"
+#include "TermPartition.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
-#include <string>
 
 namespace FDSHA {
 
+    // Aggregated firing strength (alpha) of each PGA consequent, indexed by PGATerm
+    using PGAStrengths = std::array<double, PGA_TERM_COUNT>;
+
+    // Max |findPGABatch - findPGA|. The kernels repeat the scalar operations in the same order, so
+    // results are bit-identical unless the compiler contracts the COG sums into FMAs differently.
+    constexpr double BATCH_TOLERANCE = 1e-12;
+
+    /**
+     * @brief Degrees of the terms of one input variable that can be non-zero for a crisp value;
+     *        Degrees[i] belongs to term Active->Terms[i].
+     */
+    template <std::size_t TermCount>
+    struct FuzzifiedVariable {
+        const ActiveTerms<TermCount>* Active;
+        std::array<double, TermCount> Degrees;
+    };
+
+    // Result of the fuzzification stage for one (Mmax, R, F) input
+    struct FuzzifiedInputs {
+        FuzzifiedVariable<MAGNITUDE_TERM_COUNT> Mmax;
+        FuzzifiedVariable<DISTANCE_TERM_COUNT> R;
+        FuzzifiedVariable<FAULT_TYPE_TERM_COUNT> F;
+    };
+
+    // Defuzzifier used to turn the aggregated PGA consequents into a crisp value
+    enum class DefuzzificationMethod {
+        SampledCenterOfGravity, // Discrete COG over evenly spaced sample points (reference)
+        ExactCenterOfGravity    // Closed-form COG of the piecewise-linear aggregated set
+    };
+
+    // Input variable varied by an inverse query
+    enum class InputAxis { Magnitude, Distance, FaultType };
+
+    // Ranges of one input axis on which the PGA reaches a threshold
+    struct ExceedanceIntervals {
+        std::vector<Universe> Intervals; // Disjoint and increasing; PGA >= threshold at both ends of each
+        std::size_t Evaluations = 0;     // PGA evaluations spent on the query
+    };
+
     /**
      * @brief Engine class to perform the Mamdani Fuzzy Inference for FDSHA.
+     *
+     * The rule base comes from a FuzzyModel (the built-in Anzali Port model by default), which
+     * is validated and compiled into the flat set arrays and the dense rule cube at construction.
+     *
+     * The engine owns all of its sets and tables by value, so copies are independent. Inference
+     * (findPGA, findPGABatch) is const and keeps every temporary on the caller's stack: one
+     * configured instance can serve any number of threads without locks. The setters are the
+     * only mutators; configure the engine before sharing it.
      */
     class FDSHAEngine {
     private:
-        // Maps to hold fuzzy sets
-        std::map<std::string, FuzzySet*> MmaxSets;
-        std::map<std::string, FuzzySet*> RSets;
-        std::map<std::string, FuzzySet*> FSets;
-        std::map<std::string, FuzzySet*> PGASets;
-        std::vector<FuzzyRule> Rules;
+        // Enum-indexed fuzzy sets, stored by value
+        std::array<MembershipFunction, MAGNITUDE_TERM_COUNT> MmaxSets;
+        std::array<MembershipFunction, DISTANCE_TERM_COUNT> RSets;
+        std::array<MembershipFunction, FAULT_TYPE_TERM_COUNT> FSets;
+        std::array<MembershipFunction, PGA_TERM_COUNT> PGASets;
 
-        // Initialization functions
-        void initializeFuzzySets();
-        void initializeRules();
+        // Dense rule cube: consequent of IF (Mmax AND R AND F), indexed by ruleIndex()
+        RuleCube Rules;
+
+        // Active terms per breakpoint interval of each input axis (at most 2 x 2 x 2 rules fire)
+        TermPartition<MAGNITUDE_TERM_COUNT> MmaxPartition;
+        TermPartition<DISTANCE_TERM_COUNT> RPartition;
+        TermPartition<FAULT_TYPE_TERM_COUNT> FPartition;
+
+        // Output Universe of Discourse (PGA [0.0g, 0.9g] in the built-in model)
+        double PGAMin;
+        double PGAMax;
+
+        // FuzzyModel::fingerprint() of the model the engine was built from
+        std::uint64_t ModelFingerprint;
 
-        // Helper functions
-        std::string enumToString(MagnitudeTerm t) const;
-        std::string enumToString(DistanceTerm t) const;
-        std::string enumToString(FaultTypeTerm t) const;
-        std::string enumToString(PGATerm t) const;
+        // Defuzzification settings
+        DefuzzificationMethod Defuzzification = DefuzzificationMethod::SampledCenterOfGravity;
+        int SampleCount = 1000;
+
+        // PGA set degrees at each sample point of the sampled COG, term-minor
+        std::vector<double> SampleMemberships;
+
+        // Center of gravity of each PGA set (WeightedAverage defuzzifier)
+        std::array<double, PGA_TERM_COUNT> PGACentroids;
+
+        // Instruction set used by findPGABatch
+        SimdLevel BatchSimdLevel = detectSimdLevel();
+
+        // Initialization functions
+        void buildSampleMemberships();
 
         // Defuzzification
-        double defuzzifyCenterOfGravity(const std::map<PGATerm, double>& aggregatedConsequents) const;
+        double defuzzifyCenterOfGravity(const PGAStrengths& aggregatedConsequents) const;
+        double defuzzifyExactCenterOfGravity(const PGAStrengths& aggregatedConsequents) const;
+
+        // Policy-based stages of findPGAWith
+        template <class TNorm, class Aggregation>
+        PGAStrengths inferWith(const FuzzifiedInputs& inputs) const;
+        template <class TNorm, class Aggregation>
+        double defuzzifyWith(const PGAStrengths& aggregatedConsequents, CenterOfGravity) const;
+        template <class TNorm, class Aggregation>
+        double defuzzifyWith(const PGAStrengths& aggregatedConsequents, WeightedAverage) const;
 
     public:
         FDSHAEngine();
-        ~FDSHAEngine();
+
+        /**
+         * @brief Builds an engine from a model. Throws std::invalid_argument if the model fails
+         *        FuzzyModel::validate().
+         */
+        explicit FDSHAEngine(const FuzzyModel& model);
+
+        std::uint64_t getModelFingerprint() const { return ModelFingerprint; }
+
+        /**
+         * @brief Universes of discourse of the inputs, taken from the outermost set breakpoints.
+         */
+        Universe getMagnitudeUniverse() const { return {MmaxPartition.getBreakpoints().front(), MmaxPartition.getBreakpoints().back()}; }
+        Universe getDistanceUniverse() const { return {RPartition.getBreakpoints().front(), RPartition.getBreakpoints().back()}; }
+        Universe getFaultTypeUniverse() const { return {FPartition.getBreakpoints().front(), FPartition.getBreakpoints().back()}; }
+
+        /**
+         * @brief Distance at and beyond which no R set is non-zero, so no rule can fire.
+         */
+        double getDistanceHorizon() const { return RPartition.getBreakpoints().back(); }
+
+        /**
+         * @brief Whether some set of the axis is non-zero at value. If not (outside the universe,
+         *        on its ends, in a gap between sets, or NaN), no rule can fire and findPGA returns
+         *        the empty-set fallback.
+         */
+        bool isCovered(InputAxis axis, double value) const;
+
+        /**
+         * @brief Selects the defuzzifier used by findPGA (sampled COG by default).
+         */
+        void setDefuzzificationMethod(DefuzzificationMethod method) { Defuzzification = method; }
+        DefuzzificationMethod getDefuzzificationMethod() const { return Defuzzification; }
+
+        /**
+         * @brief Sets the number of intervals used by the sampled COG (samples = count + 1).
+         */
+        void setSampleCount(int count);
+        int getSampleCount() const { return SampleCount; }
+
+        /**
+         * @brief Selects the batch kernels (clamped to what the CPU supports; best available by default).
+         */
+        void setSimdLevel(SimdLevel level) { BatchSimdLevel = std::min(level, detectSimdLevel()); }
+        SimdLevel getSimdLevel() const { return BatchSimdLevel; }
 
         /**
          * @brief Runs the fuzzy inference process to find the crisp PGA.
+         *
+         * With FDSHA_ENABLE_INSTRUMENTATION, findPGA and findPGABatch also record per-thread
+         * counters and timings (see Instrumentation.h).
+         */
+        double findPGA(double mmaxInput, double rInput, double fInput) const;
+
+        // Individual stages of findPGA: defuzzify(infer(fuzzify(mmax, r, f)))
+        FuzzifiedInputs fuzzify(double mmaxInput, double rInput, double fInput) const;
+        PGAStrengths infer(const FuzzifiedInputs& inputs) const;
+        double defuzzify(const PGAStrengths& aggregatedConsequents) const;
+
+        /**
+         * @brief findPGA with the inference operators fixed at compile time (see InferencePolicies.h).
+         *
+         * Every combination of policies instantiates its own inference path with the operators
+         * inlined. The defaults (min, max, sampled COG) give exactly findPGA with the sampled
+         * COG; the engine's defuzzification method is ignored, its sample count is not.
+         */
+        template <class TNorm = MinimumTNorm, class Aggregation = MaximumAggregation, class Defuzzifier = CenterOfGravity>
+        double findPGAWith(double mmaxInput, double rInput, double fInput) const {
+            return defuzzifyWith<TNorm, Aggregation>(inferWith<TNorm, Aggregation>(fuzzify(mmaxInput, rInput, fInput)), Defuzzifier{});
+        }
+
+        /**
+         * @brief Runs findPGA over structure-of-arrays inputs using the SIMD kernels.
+         *
+         * pgaOutputs[i] = findPGA(mmaxInputs[i], rInputs[i], fInputs[i]) within BATCH_TOLERANCE.
          */
-        double findPGA(double mmaxInput, double rInput, double fInput);
+        void findPGABatch(const double* mmaxInputs, const double* rInputs, const double* fInputs,
+                          double* pgaOutputs, std::size_t count) const;
+
+        /**
+         * @brief PGA curve along one input axis with the other two inputs fixed:
+         *        pgaOutputs[i] = findPGA with the varied input set to axisValues[i], within
+         *        BATCH_TOLERANCE. The input of the varied axis is ignored.
+         *
+         * The fixed inputs are fuzzified once and folded into a per-term ceiling (the strongest
+         * fixed-input rule strength of each consequent), so a point only evaluates its own one or
+         * two active terms. Increasing axis values step through the breakpoints without a search,
+         * points with the same rule strengths as their predecessor reuse its PGA, and the rest are
+         * defuzzified in blocks by the batch kernels.
+         */
+        void findPGASweep(InputAxis axis, double mmaxInput, double rInput, double fInput, const double* axisValues,
+                          double* pgaOutputs, std::size_t count) const;
+
+        /**
+         * @brief Inverse query: the ranges of one input (within its universe) on which the PGA is
+         *        at least threshold while the other two inputs stay fixed. The input of the varied
+         *        axis is ignored.
+         *
+         * Between two breakpoints of the axis the active rules are fixed and every degree is
+         * linear, so the rule strengths only change slope where two degrees cross or a degree
+         * crosses a fixed-input degree. The axis is cut at all of those points, each piece is
+         * probed at its ends and midpoint, and every change of side is bisected down to
+         * tolerance (in the axis' units). Interval ends reported inside the universe lie on the
+         * exceeding side of the crossing. Two crossings between the same two probes are not
+         * resolved.
+         */
+        ExceedanceIntervals findExceedanceIntervals(InputAxis axis, double threshold, double mmaxInput, double rInput,
+                                                    double fInput, double tolerance = 1e-9) const;
+
+        /**
+         * @brief findExceedanceIntervals for count queries at once (e.g. one per fault). Probes and
+         *        bisection steps of all queries are evaluated together through findPGABatch. The
+         *        input array of the varied axis may be null.
+         */
+        void findExceedanceIntervalsBatch(InputAxis axis, double threshold, const double* mmaxInputs, const double* rInputs,
+                                          const double* fInputs, ExceedanceIntervals* results, std::size_t count,
+                                          double tolerance = 1e-9) const;
     };
 
+    // --- Policy-based Inference ---
+    template <class TNorm, class Aggregation>
+    PGAStrengths FDSHAEngine::inferWith(const FuzzifiedInputs& inputs) const {
+        const ActiveTerms<MAGNITUDE_TERM_COUNT>& mmaxTerms = *inputs.Mmax.Active;
+        const ActiveTerms<DISTANCE_TERM_COUNT>& rTerms = *inputs.R.Active;
+        const ActiveTerms<FAULT_TYPE_TERM_COUNT>& fTerms = *inputs.F.Active;
+        PGAStrengths aggregatedConsequents{};
+
+        for (std::size_t m = 0; m < mmaxTerms.Count; ++m) {
+            for (std::size_t r = 0; r < rTerms.Count; ++r) {
+                for (std::size_t f = 0; f < fTerms.Count; ++f) {
+                    double alpha = TNorm::apply(TNorm::apply(inputs.Mmax.Degrees[m], inputs.R.Degrees[r]), inputs.F.Degrees[f]);
+                    std::size_t term = toIndex(Rules[ruleIndex(mmaxTerms.Terms[m], rTerms.Terms[r], fTerms.Terms[f])]);
+                    aggregatedConsequents[term] = Aggregation::apply(aggregatedConsequents[term], alpha);
+                }
+            }
+        }
+        return aggregatedConsequents;
+    }
+
+    template <class TNorm, class Aggregation>
+    double FDSHAEngine::defuzzifyWith(const PGAStrengths& aggregatedConsequents, CenterOfGravity) const {
+        const double STEP_SIZE = (PGAMax - PGAMin) / SampleCount;
+
+        std::array<std::size_t, PGA_TERM_COUNT> activeTerms;
+        std::size_t activeCount = 0;
+        for (std::size_t term = 0; term < PGA_TERM_COUNT; ++term) {
+            if (aggregatedConsequents[term] > 0.0) activeTerms[activeCount++] = term;
+        }
+        if (activeCount == 0) return (PGAMin + PGAMax) / 2.0;
+
+        double numerator = 0.0;
+        double denominator = 0.0;
+        for (int i = 0; i <= SampleCount; ++i) {
+            double x = PGAMin + i * STEP_SIZE;
+            const double* baseMemberships = &SampleMemberships[static_cast<std::size_t>(i) * PGA_TERM_COUNT];
+            double aggregatedMembership = 0.0;
+            for (std::size_t k = 0; k < activeCount; ++k) {
+                std::size_t term = activeTerms[k];
+                double shapedMembership = TNorm::apply(baseMemberships[term], aggregatedConsequents[term]);
+                aggregatedMembership = Aggregation::apply(aggregatedMembership, shapedMembership);
+            }
+            numerator += x * aggregatedMembership;
+            denominator += aggregatedMembership;
+        }
+
+        if (denominator == 0.0) return (PGAMin + PGAMax) / 2.0;
+        return numerator / denominator;
+    }
+
+    template <class TNorm, class Aggregation>
+    double FDSHAEngine::defuzzifyWith(const PGAStrengths& aggregatedConsequents, WeightedAverage) const {
+        double numerator = 0.0;
+        double denominator = 0.0;
+        for (std::size_t term = 0; term < PGA_TERM_COUNT; ++term) {
+            numerator += aggregatedConsequents[term] * PGACentroids[term];
+            denominator += aggregatedConsequents[term];
+        }
+        if (denominator == 0.0) return (PGAMin + PGAMax) / 2.0;
+        return numerator / denominator;
+    }
+
 } // namespace FDSHA
 
 #endif // FDSHAENGINE_H
@@ -0,0 +1,95 @@
+#include "FaultIndex.h"
+#include "Geodesy.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace FDSHA {
+
+    namespace {
+        // Lower bound on the cell size so tiny horizons do not explode the grid
+        const double MIN_CELL_DEGREES = 0.05;
+    }
+
+    FaultIndex::FaultIndex(const std::vector<Fault>& faults, double horizonKm) : Horizon(horizonKm) {
+        if (!(horizonKm > 0.0)) throw std::invalid_argument("FaultIndex: horizon must be positive");
+
+        // One cell spans the horizon along a meridian
+        CellDegrees = std::max(horizonKm / (EARTH_RADIUS_KM * DEGREES_TO_RADIANS), MIN_CELL_DEGREES);
+        LatitudeCells = static_cast<std::size_t>(std::ceil(180.0 / CellDegrees));
+        LongitudeCells = static_cast<std::size_t>(std::ceil(360.0 / CellDegrees));
+
+        // Counting sort of the faults into their cells
+        std::vector<std::size_t> cellOf(faults.size());
+        CellStart.assign(LatitudeCells * LongitudeCells + 1, 0);
+        for (std::size_t i = 0; i < faults.size(); ++i) {
+            if (!std::isfinite(faults[i].Latitude) || !std::isfinite(faults[i].Longitude)) {
+                throw std::invalid_argument("FaultIndex: fault " + std::to_string(i) + " has non-finite coordinates");
+            }
+            cellOf[i] = latitudeCell(faults[i].Latitude) * LongitudeCells + longitudeCell(faults[i].Longitude);
+            ++CellStart[cellOf[i] + 1];
+        }
+        for (std::size_t c = 1; c < CellStart.size(); ++c) CellStart[c] += CellStart[c - 1];
+
+        std::vector<std::uint32_t> fill(CellStart.begin(), CellStart.end() - 1);
+        CellFaults.resize(faults.size());
+        Latitudes.reserve(faults.size());
+        Longitudes.reserve(faults.size());
+        for (std::size_t i = 0; i < faults.size(); ++i) {
+            CellFaults[fill[cellOf[i]]++] = static_cast<std::uint32_t>(i);
+            Latitudes.push_back(faults[i].Latitude);
+            Longitudes.push_back(faults[i].Longitude);
+        }
+    }
+
+    std::size_t FaultIndex::latitudeCell(double latitude) const {
+        double cell = std::floor((latitude + 90.0) / CellDegrees);
+        return static_cast<std::size_t>(std::clamp(cell, 0.0, static_cast<double>(LatitudeCells - 1)));
+    }
+
+    std::size_t FaultIndex::longitudeCell(double longitude) const {
+        double wrapped = std::fmod(longitude + 180.0, 360.0);
+        if (wrapped < 0.0) wrapped += 360.0;
+        double cell = std::floor(wrapped / CellDegrees);
+        return static_cast<std::size_t>(std::min(cell, static_cast<double>(LongitudeCells - 1)));
+    }
+
+    void FaultIndex::query(double latitude, double longitude, std::vector<NearbyFault>& nearby) const {
+        nearby.clear();
+        if (!std::isfinite(latitude) || !std::isfinite(longitude)) return;
+
+        // Angular radius of the horizon cap
+        double capRadians = Horizon / EARTH_RADIUS_KM;
+        double capDegrees = capRadians / DEGREES_TO_RADIANS;
+        std::size_t latitudeBegin = latitudeCell(latitude - capDegrees);
+        std::size_t latitudeEnd = latitudeCell(latitude + capDegrees);
+
+        // Longitude half-width of the cap; a cap that reaches a pole spans every longitude
+        std::size_t longitudeSpan = LongitudeCells;
+        std::size_t longitudeBegin = 0;
+        double cosLatitude = std::cos(latitude * DEGREES_TO_RADIANS);
+        if (capRadians < 3.14159265358979323846 / 2.0 && std::sin(capRadians) < cosLatitude) {
+            double halfWidth = std::asin(std::sin(capRadians) / cosLatitude) / DEGREES_TO_RADIANS;
+            longitudeBegin = longitudeCell(longitude - halfWidth);
+            std::size_t longitudeEnd = longitudeCell(longitude + halfWidth);
+            longitudeSpan = (longitudeEnd + LongitudeCells - longitudeBegin) % LongitudeCells + 1;
+            longitudeSpan = std::min(longitudeSpan, LongitudeCells);
+        }
+
+        for (std::size_t latCell = latitudeBegin; latCell <= latitudeEnd; ++latCell) {
+            for (std::size_t k = 0; k < longitudeSpan; ++k) {
+                std::size_t cell = latCell * LongitudeCells + (longitudeBegin + k) % LongitudeCells;
+                for (std::uint32_t c = CellStart[cell]; c < CellStart[cell + 1]; ++c) {
+                    std::uint32_t fault = CellFaults[c];
+                    double distance = greatCircleDistance(latitude, longitude, Latitudes[fault], Longitudes[fault]);
+                    if (distance < Horizon) nearby.push_back({fault, distance});
+                }
+            }
+        }
+
+        // Catalog order keeps reductions deterministic regardless of cell layout
+        std::sort(nearby.begin(), nearby.end(), [](const NearbyFault& a, const NearbyFault& b) { return a.Index < b.Index; });
+    }
+
+} // namespace FDSHA
@@ -0,0 +1,58 @@
+#ifndef FAULTINDEX_H
+#define FAULTINDEX_H
+
+#include "HazardMap.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace FDSHA {
+
+    // A fault within the horizon of a query site
+    struct NearbyFault {
+        std::uint32_t Index;   // position in the catalog
+        double Distance;       // km, great-circle
+    };
+
+    /**
+     * @brief Uniform latitude/longitude bucket grid over a fault catalog that answers
+     *        "which faults lie within the distance horizon of this site".
+     *
+     * Cells are about one horizon wide, so a query visits a handful of cells around the site
+     * and confirms each candidate with the exact great-circle distance.
+     */
+    class FaultIndex {
+    private:
+        double Horizon;        // km; faults at or beyond this distance are never returned
+        double CellDegrees;
+        std::size_t LatitudeCells;
+        std::size_t LongitudeCells;
+
+        // Compressed cell lists: faults of cell c are CellFaults[CellStart[c] .. CellStart[c + 1])
+        std::vector<std::uint32_t> CellStart;
+        std::vector<std::uint32_t> CellFaults;
+        std::vector<double> Latitudes;
+        std::vector<double> Longitudes;
+
+        std::size_t latitudeCell(double latitude) const;
+        std::size_t longitudeCell(double longitude) const;
+
+    public:
+        /**
+         * @brief Throws std::invalid_argument on a non-positive horizon or a fault with a
+         *        non-finite latitude or longitude.
+         */
+        FaultIndex(const std::vector<Fault>& faults, double horizonKm);
+
+        /**
+         * @brief Replaces nearby with the faults closer than the horizon to the site, in ascending
+         *        catalog order (none for a non-finite site).
+         */
+        void query(double latitude, double longitude, std::vector<NearbyFault>& nearby) const;
+
+        double getHorizon() const { return Horizon; }
+    };
+
+} // namespace FDSHA
+
+#endif // FAULTINDEX_H
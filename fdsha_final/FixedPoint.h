@@ -0,0 +1,84 @@
+#ifndef FIXEDPOINT_H
+#define FIXEDPOINT_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace FDSHA {
+
+    /**
+     * @brief Binary fixed-point number: value = Raw / 2^FractionBits.
+     *
+     * Products and quotients go through the Wide type and are rounded to nearest, so one
+     * operation is off by at most half a unit in the last place (2^-(FractionBits + 1)).
+     * Conversions from double saturate and map NaN to the lowest value; arithmetic does
+     * not saturate, so values must stay within the range of Storage.
+     */
+    template <typename Storage, typename Wide, int FractionBits>
+    class FixedPoint {
+        static_assert(std::is_signed<Storage>::value && std::is_signed<Wide>::value, "FixedPoint needs signed storage");
+        static_assert(sizeof(Wide) >= 2 * sizeof(Storage), "FixedPoint needs a double-width intermediate type");
+        static_assert(FractionBits > 0 && FractionBits < std::numeric_limits<Storage>::digits, "FixedPoint fraction bits out of range");
+
+    private:
+        Storage Raw = 0;
+
+        static constexpr Wide ONE = Wide{1} << FractionBits;
+
+        static FixedPoint fromRaw(Wide raw) {
+            FixedPoint result;
+            result.Raw = static_cast<Storage>(raw);
+            return result;
+        }
+
+    public:
+        FixedPoint() = default;
+
+        explicit FixedPoint(double value) {
+            const double LIMIT = std::ldexp(1.0, std::numeric_limits<Storage>::digits - FractionBits);
+            if (!(value > -LIMIT)) Raw = std::numeric_limits<Storage>::min();
+            else if (value >= LIMIT) Raw = std::numeric_limits<Storage>::max();
+            else Raw = static_cast<Storage>(std::lround(std::ldexp(value, FractionBits)));
+        }
+
+        explicit operator double() const { return std::ldexp(static_cast<double>(Raw), -FractionBits); }
+
+        // Smallest positive step
+        static double resolution() { return std::ldexp(1.0, -FractionBits); }
+
+        FixedPoint operator+(FixedPoint other) const { return fromRaw(Wide{Raw} + other.Raw); }
+        FixedPoint operator-(FixedPoint other) const { return fromRaw(Wide{Raw} - other.Raw); }
+        FixedPoint operator-() const { return fromRaw(-Wide{Raw}); }
+        FixedPoint& operator+=(FixedPoint other) { return *this = *this + other; }
+
+        FixedPoint operator*(FixedPoint other) const {
+            return fromRaw((Wide{Raw} * other.Raw + (ONE >> 1)) >> FractionBits);
+        }
+
+        FixedPoint operator/(FixedPoint other) const {
+            Wide numerator = Wide{Raw} * ONE;
+            Wide quotient = numerator / other.Raw;
+            Wide remainder = numerator % other.Raw;
+            // Round half away from zero
+            if (2 * (remainder < 0 ? -remainder : remainder) >= (other.Raw < 0 ? -Wide{other.Raw} : Wide{other.Raw})) {
+                quotient += (numerator < 0) == (other.Raw < 0) ? 1 : -1;
+            }
+            return fromRaw(quotient);
+        }
+
+        bool operator==(FixedPoint other) const { return Raw == other.Raw; }
+        bool operator!=(FixedPoint other) const { return Raw != other.Raw; }
+        bool operator<(FixedPoint other) const { return Raw < other.Raw; }
+        bool operator<=(FixedPoint other) const { return Raw <= other.Raw; }
+        bool operator>(FixedPoint other) const { return Raw > other.Raw; }
+        bool operator>=(FixedPoint other) const { return Raw >= other.Raw; }
+    };
+
+    // Q15.16 in 32 bits: covers every built-in universe (|x| < 32768) with 1.5e-5 resolution
+    using Fixed32 = FixedPoint<std::int32_t, std::int64_t, 16>;
+
+} // namespace FDSHA
+
+#endif // FIXEDPOINT_H
@@ -0,0 +1,429 @@
+#include "FuzzyModel.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace FDSHA {
+
+    namespace {
+
+        const char* const MAGNITUDE_TERM_NAMES[] = {"Short", "Medium", "Large", "VeryLarge", "VeryVeryLarge"};
+        const char* const DISTANCE_TERM_NAMES[] = {"Near", "Medium", "Far", "VeryFar"};
+        const char* const FAULT_TYPE_TERM_NAMES[] = {"Normal", "Oblique", "Thrust"};
+        const char* const PGA_TERM_NAMES[] = {"VeryLow", "Low", "Medium", "Much", "VeryMuch", "VeryVeryMuch"};
+
+        const char* const FORMAT_HEADER = "fdsha-model";
+        const char* const FORMAT_VERSION = "1";
+
+        // Variables in file order, with their fixed vocabulary
+        struct VariableSpec {
+            const char* Name;
+            const char* const* Terms;
+            std::size_t TermCount;
+        };
+
+        const VariableSpec VARIABLES[] = {
+            {"Mmax", MAGNITUDE_TERM_NAMES, MAGNITUDE_TERM_COUNT},
+            {"R", DISTANCE_TERM_NAMES, DISTANCE_TERM_COUNT},
+            {"F", FAULT_TYPE_TERM_NAMES, FAULT_TYPE_TERM_COUNT},
+            {"PGA", PGA_TERM_NAMES, PGA_TERM_COUNT},
+        };
+        const std::size_t VARIABLE_COUNT = sizeof(VARIABLES) / sizeof(VARIABLES[0]);
+        const std::size_t PGA_VARIABLE = 3;
+
+        Universe& universeOf(FuzzyModel& model, std::size_t variable) {
+            Universe* universes[] = {&model.MmaxUniverse, &model.RUniverse, &model.FUniverse, &model.PGAUniverse};
+            return *universes[variable];
+        }
+
+        const Universe& universeOf(const FuzzyModel& model, std::size_t variable) {
+            return universeOf(const_cast<FuzzyModel&>(model), variable);
+        }
+
+        MembershipFunction* setsOf(FuzzyModel& model, std::size_t variable) {
+            MembershipFunction* sets[] = {model.MmaxSets.data(), model.RSets.data(), model.FSets.data(), model.PGASets.data()};
+            return sets[variable];
+        }
+
+        const MembershipFunction* setsOf(const FuzzyModel& model, std::size_t variable) {
+            return setsOf(const_cast<FuzzyModel&>(model), variable);
+        }
+
+        // Position of name in the vocabulary, or -1
+        std::ptrdiff_t findName(const char* const* names, std::size_t count, const std::string& name) {
+            for (std::size_t i = 0; i < count; ++i) {
+                if (name == names[i]) return static_cast<std::ptrdiff_t>(i);
+            }
+            return -1;
+        }
+
+        std::string describeRule(std::size_t mmax, std::size_t r, std::size_t f) {
+            return std::string("(") + MAGNITUDE_TERM_NAMES[mmax] + ", " + DISTANCE_TERM_NAMES[r] + ", " + FAULT_TYPE_TERM_NAMES[f] + ")";
+        }
+
+        void writeNumber(std::ostream& out, double value) {
+            char text[32];
+            auto result = std::to_chars(text, text + sizeof(text), value);
+            out.write(text, result.ptr - text);
+        }
+
+        // Line-by-line reader that reports errors as "source:line: message"
+        class Parser {
+        private:
+            const std::string& Source;
+            std::size_t LineNumber = 0;
+
+        public:
+            explicit Parser(const std::string& source) : Source(source) {}
+
+            void nextLine() { ++LineNumber; }
+
+            [[noreturn]] void fail(const std::string& message) const {
+                throw std::runtime_error(Source + ":" + std::to_string(LineNumber) + ": " + message);
+            }
+
+            double number(const std::string& token) const {
+                double value = 0.0;
+                auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+                if (result.ec != std::errc() || result.ptr != token.data() + token.size()) fail("'" + token + "' is not a number");
+                return value;
+            }
+
+            std::size_t variable(const std::string& token) const {
+                for (std::size_t v = 0; v < VARIABLE_COUNT; ++v) {
+                    if (token == VARIABLES[v].Name) return v;
+                }
+                fail("unknown variable '" + token + "' (expected Mmax, R, F or PGA)");
+            }
+
+            std::size_t term(std::size_t variable, const std::string& token) const {
+                const VariableSpec& spec = VARIABLES[variable];
+                std::ptrdiff_t index = findName(spec.Terms, spec.TermCount, token);
+                if (index < 0) fail("unknown " + std::string(spec.Name) + " term '" + token + "'");
+                return static_cast<std::size_t>(index);
+            }
+        };
+
+    } // namespace
+
+    // --- Built-in Model (Anzali Port) ---
+    FuzzyModel FuzzyModel::builtin() {
+        FuzzyModel model;
+        model.MmaxUniverse = {4.5, 8.5};
+        model.RUniverse = {0.0, 200.0};
+        model.FUniverse = {-0.1, 0.1};
+        model.PGAUniverse = {0.0, 0.9};
+
+        // Mmax Sets [4.5, 8.5]
+        model.MmaxSets[toIndex(MagnitudeTerm::Short)] = MembershipFunction::trapezoidal(4.5, 4.5, 5.0, 5.5);
+        model.MmaxSets[toIndex(MagnitudeTerm::Medium)] = MembershipFunction::triangular(5.0, 5.7, 6.4);
+        model.MmaxSets[toIndex(MagnitudeTerm::Large)] = MembershipFunction::triangular(6.0, 6.7, 7.4);
+        model.MmaxSets[toIndex(MagnitudeTerm::VeryLarge)] = MembershipFunction::triangular(7.0, 7.7, 8.1);
+        model.MmaxSets[toIndex(MagnitudeTerm::VeryVeryLarge)] = MembershipFunction::trapezoidal(7.8, 8.3, 8.5, 8.5);
+
+        // R Sets [0, 200] km
+        model.RSets[toIndex(DistanceTerm::Near)] = MembershipFunction::trapezoidal(0.0, 0.0, 20.0, 40.0);
+        model.RSets[toIndex(DistanceTerm::Medium)] = MembershipFunction::triangular(20.0, 50.0, 80.0);
+        model.RSets[toIndex(DistanceTerm::Far)] = MembershipFunction::triangular(60.0, 100.0, 140.0);
+        model.RSets[toIndex(DistanceTerm::VeryFar)] = MembershipFunction::trapezoidal(120.0, 160.0, 200.0, 200.0);
+
+        // F Sets [-0.1, 0.1] (Simplified Fault Index)
+        model.FSets[toIndex(FaultTypeTerm::Normal)] = MembershipFunction::trapezoidal(-0.1, -0.1, -0.05, 0.0);
+        model.FSets[toIndex(FaultTypeTerm::Oblique)] = MembershipFunction::triangular(-0.05, 0.0, 0.05);
+        model.FSets[toIndex(FaultTypeTerm::Thrust)] = MembershipFunction::trapezoidal(0.0, 0.05, 0.1, 0.1);
+
+        // PGA Sets [0, 0.9]g
+        model.PGASets[toIndex(PGATerm::VeryLow)] = MembershipFunction::trapezoidal(0.0, 0.0, 0.05, 0.15);
+        model.PGASets[toIndex(PGATerm::Low)] = MembershipFunction::triangular(0.05, 0.15, 0.25);
+        model.PGASets[toIndex(PGATerm::Medium)] = MembershipFunction::triangular(0.15, 0.30, 0.45);
+        model.PGASets[toIndex(PGATerm::Much)] = MembershipFunction::triangular(0.35, 0.50, 0.65);
+        model.PGASets[toIndex(PGATerm::VeryMuch)] = MembershipFunction::triangular(0.55, 0.70, 0.85);
+        model.PGASets[toIndex(PGATerm::VeryVeryMuch)] = MembershipFunction::trapezoidal(0.75, 0.85, 0.9, 0.9);
+
+        // --- Rule Base (60 Rules) ---
+        // Total: 60 Rules (3 Fault Types * 4 Distances * 5 Magnitudes)
+        std::vector<FuzzyRule>& rules = model.Rules;
+        rules.reserve(RULE_COUNT);
+
+        // I. IF Fault Type (F) is NORMAL
+        rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::Near, FaultTypeTerm::Normal, PGATerm::Low);
+        rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::Near, FaultTypeTerm::Normal, PGATerm::Medium);
+        rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::Near, FaultTypeTerm::Normal, PGATerm::Much);
+        rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::Near, FaultTypeTerm::Normal, PGATerm::VeryMuch);
+        rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::Near, FaultTypeTerm::Normal, PGATerm::VeryMuch);
+        rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::Medium, FaultTypeTerm::Normal, PGATerm::VeryLow);
+        rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::Medium, FaultTypeTerm::Normal, PGATerm::Low);
+        rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::Medium, FaultTypeTerm::Normal, PGATerm::Medium);
+        rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::Medium, FaultTypeTerm::Normal, PGATerm::Much);
+        rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::Medium, FaultTypeTerm::Normal, PGATerm::VeryMuch);
+        rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::Far, FaultTypeTerm::Normal, PGATerm::VeryLow);
+        rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::Far, FaultTypeTerm::Normal, PGATerm::VeryLow);
+        rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::Far, FaultTypeTerm::Normal, PGATerm::Low);
+        rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::Far, FaultTypeTerm::Normal, PGATerm::Medium);
+        rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::Far, FaultTypeTerm::Normal, PGATerm::Much);
+        rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::VeryFar, FaultTypeTerm::Normal, PGATerm::VeryLow);
+        rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::VeryFar, FaultTypeTerm::Normal, PGATerm::VeryLow);
+        rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::VeryFar, FaultTypeTerm::Normal, PGATerm::VeryLow);
+        rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::VeryFar, FaultTypeTerm::Normal, PGATerm::Low);
+        rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::VeryFar, FaultTypeTerm::Normal, PGATerm::Medium);
+
+        // II. IF Fault Type (F) is OBLIQUE
+        rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::Near, FaultTypeTerm::Oblique, PGATerm::Medium);
+        rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::Near, FaultTypeTerm::Oblique, PGATerm::Much);
+        rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::Near, FaultTypeTerm::Oblique, PGATerm::VeryMuch);
+        rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::Near, FaultTypeTerm::Oblique, PGATerm::VeryMuch);
+        rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::Near, FaultTypeTerm::Oblique, PGATerm::VeryVeryMuch);
+        rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::Medium, FaultTypeTerm::Oblique, PGATerm::Low);
+        rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::Medium, FaultTypeTerm::Oblique, PGATerm::Medium);
+        rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::Medium, FaultTypeTerm::Oblique, PGATerm::Much);
+        rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::Medium, FaultTypeTerm::Oblique, PGATerm::VeryMuch);
+        rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::Medium, FaultTypeTerm::Oblique, PGATerm::VeryMuch);
+        rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::Far, FaultTypeTerm::Oblique, PGATerm::VeryLow);
+        rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::Far, FaultTypeTerm::Oblique, PGATerm::Low);
+        rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::Far, FaultTypeTerm::Oblique, PGATerm::Medium);
+        rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::Far, FaultTypeTerm::Oblique, PGATerm::Much);
+        rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::Far, FaultTypeTerm::Oblique, PGATerm::VeryMuch);
+        rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::VeryFar, FaultTypeTerm::Oblique, PGATerm::VeryLow);
+        rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::VeryFar, FaultTypeTerm::Oblique, PGATerm::VeryLow);
+        rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::VeryFar, FaultTypeTerm::Oblique, PGATerm::Low);
+        rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::VeryFar, FaultTypeTerm::Oblique, PGATerm::Medium);
+        rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::VeryFar, FaultTypeTerm::Oblique, PGATerm::Much);
+
+        // III. IF Fault Type (F) is THRUST
+        rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::Near, FaultTypeTerm::Thrust, PGATerm::Much);
+        rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::Near, FaultTypeTerm::Thrust, PGATerm::VeryMuch);
+        rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::Near, FaultTypeTerm::Thrust, PGATerm::VeryVeryMuch);
+        rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::Near, FaultTypeTerm::Thrust, PGATerm::VeryVeryMuch);
+        rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::Near, FaultTypeTerm::Thrust, PGATerm::VeryVeryMuch);
+        rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::Medium, FaultTypeTerm::Thrust, PGATerm::Medium);
+        rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::Medium, FaultTypeTerm::Thrust, PGATerm::Much);
+        rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::Medium, FaultTypeTerm::Thrust, PGATerm::VeryMuch);
+        rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::Medium, FaultTypeTerm::Thrust, PGATerm::VeryMuch);
+        rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::Medium, FaultTypeTerm::Thrust, PGATerm::VeryVeryMuch);
+        rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::Far, FaultTypeTerm::Thrust, PGATerm::Low);
+        rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::Far, FaultTypeTerm::Thrust, PGATerm::Medium);
+        rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::Far, FaultTypeTerm::Thrust, PGATerm::Much);
+        rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::Far, FaultTypeTerm::Thrust, PGATerm::VeryMuch);
+        rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::Far, FaultTypeTerm::Thrust, PGATerm::VeryMuch);
+        rules.emplace_back(MagnitudeTerm::Short, DistanceTerm::VeryFar, FaultTypeTerm::Thrust, PGATerm::VeryLow);
+        rules.emplace_back(MagnitudeTerm::Medium, DistanceTerm::VeryFar, FaultTypeTerm::Thrust, PGATerm::Low);
+        rules.emplace_back(MagnitudeTerm::Large, DistanceTerm::VeryFar, FaultTypeTerm::Thrust, PGATerm::Medium);
+        rules.emplace_back(MagnitudeTerm::VeryLarge, DistanceTerm::VeryFar, FaultTypeTerm::Thrust, PGATerm::Much);
+        rules.emplace_back(MagnitudeTerm::VeryVeryLarge, DistanceTerm::VeryFar, FaultTypeTerm::Thrust, PGATerm::VeryMuch);
+
+        return model;
+    }
+
+    // --- Text Format ---
+    FuzzyModel FuzzyModel::load(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) throw std::runtime_error("FuzzyModel: cannot open " + path);
+        return parse(in, path);
+    }
+
+    FuzzyModel FuzzyModel::parse(std::istream& in, const std::string& source) {
+        FuzzyModel model;
+        Parser parser(source);
+        bool sawHeader = false;
+        std::array<bool, VARIABLE_COUNT> universeDefined{};
+        std::array<std::array<bool, PGA_TERM_COUNT>, VARIABLE_COUNT> setDefined{};
+
+        std::string line;
+        while (std::getline(in, line)) {
+            parser.nextLine();
+            std::size_t comment = line.find('#');
+            if (comment != std::string::npos) line.erase(comment);
+
+            std::istringstream tokens(line);
+            std::vector<std::string> words;
+            for (std::string word; tokens >> word;) words.push_back(word);
+            if (words.empty()) continue;
+
+            const std::string& keyword = words[0];
+            if (!sawHeader) {
+                if (words.size() != 2 || keyword != FORMAT_HEADER || words[1] != FORMAT_VERSION) {
+                    parser.fail(std::string("expected '") + FORMAT_HEADER + " " + FORMAT_VERSION + "' header");
+                }
+                sawHeader = true;
+            } else if (keyword == "universe") {
+                if (words.size() != 4) parser.fail("expected 'universe VARIABLE MIN MAX'");
+                std::size_t variable = parser.variable(words[1]);
+                if (universeDefined[variable]) parser.fail("universe of " + words[1] + " defined twice");
+                universeDefined[variable] = true;
+                universeOf(model, variable) = {parser.number(words[2]), parser.number(words[3])};
+            } else if (keyword == "set") {
+                if (words.size() < 4) parser.fail("expected 'set VARIABLE TERM triangular|trapezoidal BREAKPOINTS...'");
+                std::size_t variable = parser.variable(words[1]);
+                std::size_t term = parser.term(variable, words[2]);
+                if (setDefined[variable][term]) parser.fail(words[1] + " " + words[2] + " defined twice");
+                setDefined[variable][term] = true;
+
+                MembershipFunction& set = setsOf(model, variable)[term];
+                if (words[3] == "triangular" && words.size() == 7) {
+                    set = MembershipFunction::triangular(parser.number(words[4]), parser.number(words[5]), parser.number(words[6]));
+                } else if (words[3] == "trapezoidal" && words.size() == 8) {
+                    set = MembershipFunction::trapezoidal(parser.number(words[4]), parser.number(words[5]),
+                                                          parser.number(words[6]), parser.number(words[7]));
+                } else {
+                    parser.fail("expected 'triangular A B C' or 'trapezoidal A B C D'");
+                }
+            } else if (keyword == "rule") {
+                if (words.size() != 5) parser.fail("expected 'rule MMAX R F PGA'");
+                model.Rules.emplace_back(static_cast<MagnitudeTerm>(parser.term(0, words[1])),
+                                         static_cast<DistanceTerm>(parser.term(1, words[2])),
+                                         static_cast<FaultTypeTerm>(parser.term(2, words[3])),
+                                         static_cast<PGATerm>(parser.term(PGA_VARIABLE, words[4])));
+            } else {
+                parser.fail("unknown keyword '" + keyword + "'");
+            }
+        }
+
+        if (!sawHeader) throw std::runtime_error(source + ": empty model file");
+        for (std::size_t variable = 0; variable < VARIABLE_COUNT; ++variable) {
+            const VariableSpec& spec = VARIABLES[variable];
+            if (!universeDefined[variable]) throw std::runtime_error(source + ": missing universe of " + spec.Name);
+            for (std::size_t term = 0; term < spec.TermCount; ++term) {
+                if (!setDefined[variable][term]) throw std::runtime_error(source + ": missing set " + spec.Name + " " + spec.Terms[term]);
+            }
+        }
+        return model;
+    }
+
+    void FuzzyModel::save(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) throw std::runtime_error("FuzzyModel: cannot write " + path);
+        write(out);
+        if (!out) throw std::runtime_error("FuzzyModel: error while writing " + path);
+    }
+
+    void FuzzyModel::write(std::ostream& out) const {
+        out << FORMAT_HEADER << " " << FORMAT_VERSION << "\n";
+        for (std::size_t variable = 0; variable < VARIABLE_COUNT; ++variable) {
+            const VariableSpec& spec = VARIABLES[variable];
+            const Universe& universe = universeOf(*this, variable);
+            out << "\nuniverse " << spec.Name << " ";
+            writeNumber(out, universe.Min);
+            out << " ";
+            writeNumber(out, universe.Max);
+            out << "\n";
+
+            for (std::size_t term = 0; term < spec.TermCount; ++term) {
+                const MembershipFunction& set = setsOf(*this, variable)[term];
+                bool triangular = set.b == set.c;
+                out << "set " << spec.Name << " " << spec.Terms[term] << (triangular ? " triangular" : " trapezoidal");
+                // A triangle is stored as (a, b, b, c): write its breakpoints without the repeated peak
+                const double breakpoints[] = {set.a, set.b, set.c, set.d};
+                for (std::size_t i = 0; i < 4; ++i) {
+                    if (triangular && i == 2) continue;
+                    out << " ";
+                    writeNumber(out, breakpoints[i]);
+                }
+                out << "\n";
+            }
+        }
+
+        out << "\n# IF Mmax AND R AND F THEN PGA\n";
+        for (const FuzzyRule& rule : Rules) {
+            out << "rule " << MAGNITUDE_TERM_NAMES[toIndex(rule.Mmax)] << " " << DISTANCE_TERM_NAMES[toIndex(rule.R)] << " "
+                << FAULT_TYPE_TERM_NAMES[toIndex(rule.F)] << " " << PGA_TERM_NAMES[toIndex(rule.PGA)] << "\n";
+        }
+    }
+
+    // --- Validation ---
+    void FuzzyModel::validate() const {
+        for (std::size_t variable = 0; variable < VARIABLE_COUNT; ++variable) {
+            const VariableSpec& spec = VARIABLES[variable];
+            const Universe& universe = universeOf(*this, variable);
+            const MembershipFunction* sets = setsOf(*this, variable);
+            std::string prefix = std::string("FuzzyModel: ") + spec.Name;
+
+            if (!std::isfinite(universe.Min) || !std::isfinite(universe.Max) || !(universe.Min < universe.Max)) {
+                throw std::invalid_argument(prefix + " universe must be a finite, non-empty interval");
+            }
+
+            for (std::size_t term = 0; term < spec.TermCount; ++term) {
+                const MembershipFunction& set = sets[term];
+                std::string name = prefix + " " + spec.Terms[term];
+                if (!(set.a <= set.b && set.b <= set.c && set.c <= set.d && set.a < set.d)) {
+                    throw std::invalid_argument(name + " needs breakpoints a <= b <= c <= d with a < d");
+                }
+                if (set.a < universe.Min || set.d > universe.Max) {
+                    throw std::invalid_argument(name + " extends outside the universe");
+                }
+                if (term > 0) {
+                    const MembershipFunction& previous = sets[term - 1];
+                    if (set.a < previous.a || set.d < previous.d) {
+                        throw std::invalid_argument(name + " is out of order with " + spec.Terms[term - 1]);
+                    }
+                    // A set is zero at its support ends, so neighbours must overlap strictly
+                    if (!(set.a < previous.d)) {
+                        throw std::invalid_argument(prefix + " has a gap between " + spec.Terms[term - 1] + " and " + spec.Terms[term]);
+                    }
+                }
+            }
+
+            if (sets[0].a != universe.Min || sets[spec.TermCount - 1].d != universe.Max) {
+                throw std::invalid_argument(prefix + " sets do not cover the universe");
+            }
+        }
+
+        compileRules();
+    }
+
+    RuleCube FuzzyModel::compileRules() const {
+        RuleCube cube{};
+        std::array<bool, RULE_COUNT> defined{};
+        for (const auto& rule : Rules) {
+            std::size_t index = ruleIndex(toIndex(rule.Mmax), toIndex(rule.R), toIndex(rule.F));
+            if (defined[index]) {
+                throw std::invalid_argument("FuzzyModel: duplicate rule for " + describeRule(toIndex(rule.Mmax), toIndex(rule.R), toIndex(rule.F)));
+            }
+            defined[index] = true;
+            cube[index] = rule.PGA;
+        }
+        for (std::size_t m = 0; m < MAGNITUDE_TERM_COUNT; ++m) {
+            for (std::size_t r = 0; r < DISTANCE_TERM_COUNT; ++r) {
+                for (std::size_t f = 0; f < FAULT_TYPE_TERM_COUNT; ++f) {
+                    if (!defined[ruleIndex(m, r, f)]) throw std::invalid_argument("FuzzyModel: no rule for " + describeRule(m, r, f));
+                }
+            }
+        }
+        return cube;
+    }
+
+    // --- Fingerprint ---
+    std::uint64_t FuzzyModel::fingerprint() const {
+        std::uint64_t hash = 14695981039346656037ULL;
+        auto mix = [&](const void* data, std::size_t size) {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for (std::size_t i = 0; i < size; ++i) {
+                hash ^= bytes[i];
+                hash *= 1099511628211ULL;
+            }
+        };
+        auto mixNumber = [&](double value) {
+            std::uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            mix(&bits, sizeof(bits));
+        };
+
+        for (std::size_t variable = 0; variable < VARIABLE_COUNT; ++variable) {
+            const Universe& universe = universeOf(*this, variable);
+            mixNumber(universe.Min);
+            mixNumber(universe.Max);
+            const MembershipFunction* sets = setsOf(*this, variable);
+            for (std::size_t term = 0; term < VARIABLES[variable].TermCount; ++term) {
+                for (double value : {sets[term].a, sets[term].b, sets[term].c, sets[term].d}) mixNumber(value);
+            }
+        }
+        for (PGATerm consequent : compileRules()) {
+            unsigned char term = static_cast<unsigned char>(toIndex(consequent));
+            mix(&term, 1);
+        }
+        return hash;
+    }
+
+} // namespace FDSHA
@@ -0,0 +1,89 @@
+#ifndef FUZZYMODEL_H
+#define FUZZYMODEL_H
+
+#include "Enums.h"
+#include "FuzzySet.h"
+#include "FuzzyRule.h"
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace FDSHA {
+
+    /**
+     * @brief Definition of an FDSHA rule base: universes, term membership functions and rules.
+     *
+     * The linguistic vocabulary (the terms of Enums.h) is fixed; a model only recalibrates the
+     * breakpoints and the consequents, as needed when moving the method to a new region. Models
+     * are read from and written to a line-oriented text format:
+     *
+     *     fdsha-model 1
+     *     universe Mmax 4.5 8.5
+     *     set Mmax Medium triangular 5.0 5.7 6.4
+     *     set R Near trapezoidal 0 0 20 40
+     *     rule Short Near Normal Low
+     *
+     * with one universe per variable (Mmax, R, F, PGA), one set per term and one rule per
+     * (Mmax, R, F) combination; '#' starts a comment. An engine built from a model compiles it
+     * into the same flat tables as the built-in one.
+     */
+    struct FuzzyModel {
+        Universe MmaxUniverse{};
+        Universe RUniverse{};
+        Universe FUniverse{};
+        Universe PGAUniverse{};
+
+        std::array<MembershipFunction, MAGNITUDE_TERM_COUNT> MmaxSets{};
+        std::array<MembershipFunction, DISTANCE_TERM_COUNT> RSets{};
+        std::array<MembershipFunction, FAULT_TYPE_TERM_COUNT> FSets{};
+        std::array<MembershipFunction, PGA_TERM_COUNT> PGASets{};
+
+        std::vector<FuzzyRule> Rules;
+
+        /**
+         * @brief The Anzali Port model the engine ships with (60 rules).
+         */
+        static FuzzyModel builtin();
+
+        /**
+         * @brief Parses a model file. Throws std::runtime_error naming the offending line.
+         *        The result is not validated; see validate().
+         */
+        static FuzzyModel load(const std::string& path);
+        static FuzzyModel parse(std::istream& in, const std::string& source);
+
+        /**
+         * @brief Writes the model in the text format; values round-trip exactly.
+         */
+        void save(const std::string& path) const;
+        void write(std::ostream& out) const;
+
+        /**
+         * @brief Checks the model and throws std::invalid_argument on the first problem:
+         *        - every universe is finite and non-empty, and every set lies inside its universe
+         *          with a <= b <= c <= d and a < d;
+         *        - the terms of a variable are ordered along the axis, neighbouring terms overlap
+         *          and together they cover the universe, so every interior value has a non-zero degree;
+         *        - the rules cover every (Mmax, R, F) combination exactly once.
+         */
+        void validate() const;
+
+        /**
+         * @brief Packs the rules into the dense rule cube (throws like validate() on a missing or
+         *        duplicate rule).
+         */
+        RuleCube compileRules() const;
+
+        /**
+         * @brief 64-bit FNV-1a hash of the universes, the set breakpoints and the rule cube.
+         *        Independent of the order of the rules in the file.
+         */
+        std::uint64_t fingerprint() const;
+    };
+
+} // namespace FDSHA
+
+#endif // FUZZYMODEL_H
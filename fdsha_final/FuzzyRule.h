@@ -3,9 +3,21 @@
 
 #include "Enums.h"
 #include <algorithm>
+#include <array>
+#include <cstddef>
 
 namespace FDSHA {
 
+    // Total number of rules (one per Mmax x R x F combination)
+    constexpr std::size_t RULE_COUNT = MAGNITUDE_TERM_COUNT * DISTANCE_TERM_COUNT * FAULT_TYPE_TERM_COUNT;
+
+    // Dense rule cube: consequent of IF (Mmax AND R AND F), indexed by ruleIndex()
+    using RuleCube = std::array<PGATerm, RULE_COUNT>;
+
+    constexpr std::size_t ruleIndex(std::size_t mmax, std::size_t r, std::size_t f) {
+        return (mmax * DISTANCE_TERM_COUNT + r) * FAULT_TYPE_TERM_COUNT + f;
+    }
+
     /**
      * @brief Represents a single fuzzy rule: IF (Mmax AND R AND F) THEN (PGA)
      */
@@ -21,7 +33,7 @@ namespace FDSHA {
         /**
          * @brief Calculates rule's firing strength (alpha-cut) using MIN operator (T-norm).
          */
-        double getFiringStrength(double mmaxDeg, double rDeg, double fDeg) const {
+        static double getFiringStrength(double mmaxDeg, double rDeg, double fDeg) {
             return std::min({mmaxDeg, rDeg, fDeg});
         }
     };
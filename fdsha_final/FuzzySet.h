@@ -1,41 +1,50 @@
 #ifndef FUZZYSET_H_INCLUDED
 #define FUZZYSET_H_INCLUDED
-#include <string>
 
 namespace FDSHA {
 
     /**
-     * @brief Abstract base class for a Fuzzy Set and its Membership Function.
+     * @brief Value-type membership function used by the engine's hot path.
+     *
+     * A triangle (a, b, c) is stored as the trapezoid (a, b, b, c), so every set is evaluated
+     * by the same branch sequence without a virtual call.
      */
-    class FuzzySet {
-    public:
-        std::string Name;
-        virtual double getMembershipDegree(double crispValue) const = 0;
-        virtual ~FuzzySet() = default;
+    struct MembershipFunction {
+        double a = 0.0, b = 0.0, c = 0.0, d = 0.0;
+
+        static MembershipFunction triangular(double a_val, double b_val, double c_val) {
+            return {a_val, b_val, b_val, c_val};
+        }
+
+        static MembershipFunction trapezoidal(double a_val, double b_val, double c_val, double d_val) {
+            return {a_val, b_val, c_val, d_val};
+        }
+
+        double getMembershipDegree(double x) const {
+            if (x <= a || x >= d) return 0.0;
+            // Peak (membership = 1.0)
+            if (x >= b && x <= c) return 1.0;
+            // Rising slope
+            if (x < b) return (x - a) / (b - a);
+            // Falling slope
+            if (x > c) return (d - x) / (d - c);
+            return 0.0;
+        }
+
+        /**
+         * @brief Abscissa of the center of gravity of the (unclipped) set.
+         */
+        double getCentroid() const {
+            double doubleArea = (d + c) - (b + a);
+            if (doubleArea <= 0.0) return 0.5 * (a + d);
+            return ((d * d + d * c + c * c) - (a * a + a * b + b * b)) / (3.0 * doubleArea);
+        }
     };
 
-    /**
-     * @brief Implementation for a Triangular Membership Function.
-     */
-    class TriangularFuzzySet : public FuzzySet {
-    private:
-        double a, b, c;
-
-    public:
-        TriangularFuzzySet(std::string name, double a_val, double b_val, double c_val);
-        double getMembershipDegree(double x) const override;
-    };
-
-    /**
-     * @brief Implementation for a Trapezoidal Membership Function.
-     */
-    class TrapezoidalFuzzySet : public FuzzySet {
-    private:
-        double a, b, c, d;
-
-    public:
-        TrapezoidalFuzzySet(std::string name, double a_val, double b_val, double c_val, double d_val);
-        double getMembershipDegree(double x) const override;
+    // Closed interval of crisp values covered by a variable's fuzzy sets
+    struct Universe {
+        double Min;
+        double Max;
     };
 
 } // namespace FDSHA
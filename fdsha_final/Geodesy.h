@@ -0,0 +1,26 @@
+#ifndef GEODESY_H
+#define GEODESY_H
+
+#include <cmath>
+
+namespace FDSHA {
+
+    // Mean Earth radius (IUGG), km
+    constexpr double EARTH_RADIUS_KM = 6371.0088;
+    constexpr double DEGREES_TO_RADIANS = 3.14159265358979323846 / 180.0;
+
+    /**
+     * @brief Great-circle (haversine) distance in km between two points given in degrees.
+     */
+    inline double greatCircleDistance(double lat1, double lon1, double lat2, double lon2) {
+        double dLat = (lat2 - lat1) * DEGREES_TO_RADIANS;
+        double dLon = (lon2 - lon1) * DEGREES_TO_RADIANS;
+        double sinLat = std::sin(0.5 * dLat);
+        double sinLon = std::sin(0.5 * dLon);
+        double h = sinLat * sinLat + std::cos(lat1 * DEGREES_TO_RADIANS) * std::cos(lat2 * DEGREES_TO_RADIANS) * sinLon * sinLon;
+        return 2.0 * EARTH_RADIUS_KM * std::asin(std::sqrt(std::fmin(1.0, h)));
+    }
+
+} // namespace FDSHA
+
+#endif // GEODESY_H
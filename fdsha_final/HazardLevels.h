@@ -0,0 +1,31 @@
+#ifndef HAZARDLEVELS_H
+#define HAZARDLEVELS_H
+
+#include <array>
+#include <cstddef>
+
+namespace FDSHA {
+
+    // Lower PGA bounds (g) of the hazard verdicts above "Negligible", in increasing order
+    constexpr std::array<double, 5> PGA_VERDICT_THRESHOLDS = {0.10, 0.25, 0.45, 0.65, 0.80};
+
+    // provide a qualitative verdict based on the crisp PGA value
+    inline const char* getPGAVerdict(double pga) {
+        if (pga < PGA_VERDICT_THRESHOLDS[0]) {
+            return "Negligible (Very Low Hazard)";
+        } else if (pga < PGA_VERDICT_THRESHOLDS[1]) {
+            return "Low (Minor Structural Risk)";
+        } else if (pga < PGA_VERDICT_THRESHOLDS[2]) {
+            return "Moderate (Significant Damage Likely)";
+        } else if (pga < PGA_VERDICT_THRESHOLDS[3]) {
+            return "High/Much (Major Structural Damage Expected)";
+        } else if (pga < PGA_VERDICT_THRESHOLDS[4]) {
+            return "Very High/Very Much (Severe Damage, Near Collapse)";
+        } else {
+            return "Extreme/Very Very Much (Maximum Hazard, Catastrophic Damage)";
+        }
+    }
+
+} // namespace FDSHA
+
+#endif // HAZARDLEVELS_H
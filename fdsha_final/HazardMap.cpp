@@ -0,0 +1,154 @@
+#include "HazardMap.h"
+#include "FaultIndex.h"
+#include "HazardRaster.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace FDSHA {
+
+    namespace {
+
+        // Bound on the ulp steps searched for the closest covered distance
+        const int NEAREST_DISTANCE_STEPS = 1024;
+
+    } // namespace
+
+    // Scratch owned by one pool worker, padded to its own cache lines
+    struct alignas(64) HazardMapGenerator::WorkerState {
+        std::vector<NearbyFault> Nearby;
+        std::vector<std::uint32_t> Candidates;
+        std::vector<double> Distances;
+        std::vector<double> Mmax;
+        std::vector<double> FaultType;
+        std::vector<double> PGA;
+    };
+
+    HazardMapGenerator::HazardMapGenerator(const FDSHAEngine& engine, std::vector<Fault> faults, std::size_t tileSize)
+        : Engine(engine), Faults(std::move(faults)), TileSize(tileSize) {
+        if (TileSize == 0) throw std::invalid_argument("HazardMapGenerator: tile size must be positive");
+        Index = std::make_shared<FaultIndex>(Faults, Engine.getDistanceHorizon());
+
+        Scorable.reserve(Faults.size());
+        for (const Fault& fault : Faults) {
+            Scorable.push_back(Engine.isCovered(InputAxis::Magnitude, fault.Mmax) &&
+                               Engine.isCovered(InputAxis::FaultType, fault.FaultType));
+        }
+
+        // The first distance set usually starts at the universe minimum with zero membership, so
+        // the closest covered distance lies a few ulps above it
+        double distance = Engine.getDistanceUniverse().Min;
+        for (int step = 0; step < NEAREST_DISTANCE_STEPS && !Engine.isCovered(InputAxis::Distance, distance); ++step) {
+            distance = std::nextafter(distance, Engine.getDistanceHorizon());
+        }
+        NearestDistance = Engine.isCovered(InputAxis::Distance, distance) ? distance : Engine.getDistanceUniverse().Min;
+    }
+
+    HazardMapGenerator::~HazardMapGenerator() = default;
+
+    HazardMap HazardMapGenerator::generate(const SiteGrid& grid, ThreadPool& pool) const {
+        HazardMap map{grid, std::vector<double>(grid.size(), 0.0), std::vector<std::int32_t>(grid.size(), NO_FAULT)};
+        if (grid.size() == 0 || Faults.empty()) return map;
+
+        // The engine is shared read-only; workers only own their scratch buffers
+        std::vector<WorkerState> workers(pool.size());
+
+        std::size_t tileRows = (grid.Rows + TileSize - 1) / TileSize;
+        std::size_t tileColumns = (grid.Columns + TileSize - 1) / TileSize;
+
+        pool.run(tileRows * tileColumns, [&](std::size_t tile, std::size_t worker) {
+            std::size_t rowBegin = (tile / tileColumns) * TileSize;
+            std::size_t columnBegin = (tile % tileColumns) * TileSize;
+            std::size_t rowEnd = std::min(rowBegin + TileSize, grid.Rows);
+            std::size_t columnEnd = std::min(columnBegin + TileSize, grid.Columns);
+            std::size_t first = rowBegin * grid.Columns + columnBegin;
+            scoreSites(grid, rowBegin, rowEnd, columnBegin, columnEnd, map.PGA.data() + first,
+                       map.ControllingFault.data() + first, grid.Columns, workers[worker]);
+        });
+        return map;
+    }
+
+    void HazardMapGenerator::generate(HazardRasterWriter& raster, ThreadPool& pool) const {
+        const SiteGrid& grid = raster.getGrid();
+        std::size_t tileSize = raster.getTileSize();
+        std::vector<std::size_t> tiles = raster.getIncompleteTiles();
+        std::vector<WorkerState> workers(pool.size());
+
+        pool.run(tiles.size(), [&](std::size_t task, std::size_t worker) {
+            std::size_t tile = tiles[task];
+            std::size_t rowBegin = (tile / raster.getTileColumns()) * tileSize;
+            std::size_t columnBegin = (tile % raster.getTileColumns()) * tileSize;
+            std::size_t rowEnd = std::min(rowBegin + tileSize, grid.Rows);
+            std::size_t columnEnd = std::min(columnBegin + tileSize, grid.Columns);
+
+            // Every cell is written, padding included, so a resumed file holds no stale values
+            double* pga = raster.getTilePGA(tile);
+            std::int32_t* faults = raster.getTileControllingFaults(tile);
+            std::fill(pga, pga + tileSize * tileSize, 0.0);
+            if (faults != nullptr) std::fill(faults, faults + tileSize * tileSize, NO_FAULT);
+            if (!Faults.empty()) scoreSites(grid, rowBegin, rowEnd, columnBegin, columnEnd, pga, faults, tileSize, workers[worker]);
+            raster.markTileComplete(tile);
+        });
+        raster.checkpoint();
+    }
+
+    void HazardMapGenerator::scoreSites(const SiteGrid& grid, std::size_t rowBegin, std::size_t rowEnd, std::size_t columnBegin,
+                                        std::size_t columnEnd, double* pga, std::int32_t* controllingFaults, std::size_t rowStride,
+                                        WorkerState& state) const {
+        for (std::size_t row = rowBegin; row < rowEnd; ++row) {
+            double latitude = grid.latitude(row);
+            for (std::size_t column = columnBegin; column < columnEnd; ++column) {
+                double longitude = grid.longitude(column);
+                Index->query(latitude, longitude, state.Nearby);
+
+                // Only faults that fire a rule compete: the empty-set fallback is not a ground motion
+                state.Candidates.clear();
+                state.Distances.clear();
+                for (const NearbyFault& nearby : state.Nearby) {
+                    if (!Scorable[nearby.Index]) continue;
+                    double distance = std::max(nearby.Distance, NearestDistance);
+                    if (!Engine.isCovered(InputAxis::Distance, distance)) continue;
+                    state.Candidates.push_back(nearby.Index);
+                    state.Distances.push_back(distance);
+                }
+                if (state.Candidates.empty()) continue;
+
+                std::size_t count = state.Candidates.size();
+                state.Mmax.resize(count);
+                state.FaultType.resize(count);
+                state.PGA.resize(count);
+                for (std::size_t i = 0; i < count; ++i) {
+                    const Fault& fault = Faults[state.Candidates[i]];
+                    state.Mmax[i] = fault.Mmax;
+                    state.FaultType[i] = fault.FaultType;
+                }
+                Engine.findPGABatch(state.Mmax.data(), state.Distances.data(), state.FaultType.data(),
+                                          state.PGA.data(), count);
+
+                // Reduce to the maximum; ties go to the earlier fault in the catalog
+                std::size_t controlling = static_cast<std::size_t>(
+                    std::max_element(state.PGA.begin(), state.PGA.end()) - state.PGA.begin());
+                std::size_t site = (row - rowBegin) * rowStride + (column - columnBegin);
+                pga[site] = state.PGA[controlling];
+                if (controllingFaults != nullptr) controllingFaults[site] = static_cast<std::int32_t>(state.Candidates[controlling]);
+            }
+        }
+    }
+
+    std::uint64_t HazardMapGenerator::getCatalogFingerprint() const {
+        std::uint64_t hash = 14695981039346656037ULL;
+        for (const Fault& fault : Faults) {
+            for (double value : {fault.Latitude, fault.Longitude, fault.Mmax, fault.FaultType}) {
+                unsigned char bytes[sizeof(double)];
+                std::memcpy(bytes, &value, sizeof(bytes));
+                for (unsigned char byte : bytes) {
+                    hash ^= byte;
+                    hash *= 1099511628211ULL;
+                }
+            }
+        }
+        return hash;
+    }
+
+} // namespace FDSHA
@@ -0,0 +1,112 @@
+#ifndef HAZARDMAP_H
+#define HAZARDMAP_H
+
+#include "FDSHAEngine.h"
+#include "ThreadPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace FDSHA {
+
+    class FaultIndex;
+    class HazardRasterWriter;
+
+    // Controlling-fault value of a site with no contributing fault
+    constexpr std::int32_t NO_FAULT = -1;
+
+    /**
+     * @brief Seismic source: epicentre, maximum magnitude and fault-type index.
+     */
+    struct Fault {
+        double Latitude;
+        double Longitude;
+        double Mmax;
+        double FaultType;
+    };
+
+    /**
+     * @brief Regular latitude/longitude site grid (degrees), row-major from the south-west corner.
+     */
+    struct SiteGrid {
+        double MinLatitude;
+        double MinLongitude;
+        double LatitudeStep;
+        double LongitudeStep;
+        std::size_t Rows;
+        std::size_t Columns;
+
+        double latitude(std::size_t row) const { return MinLatitude + static_cast<double>(row) * LatitudeStep; }
+        double longitude(std::size_t column) const { return MinLongitude + static_cast<double>(column) * LongitudeStep; }
+        std::size_t size() const { return Rows * Columns; }
+    };
+
+    /**
+     * @brief Per-site maximum PGA and the catalog index of the fault that produces it.
+     */
+    struct HazardMap {
+        SiteGrid Grid;
+        std::vector<double> PGA;
+        std::vector<std::int32_t> ControllingFault;
+    };
+
+    /**
+     * @brief Builds hazard maps from a fault catalog: for every site, the maximum PGA over all
+     *        faults with the great-circle source-to-site distance as R.
+     *
+     * Only faults closer than the engine's distance horizon are scored: beyond it no rule fires
+     * and the defuzzifier would just return its empty-set fallback. A FaultIndex finds those
+     * faults per site. Faults whose Mmax or F no set covers (see FDSHAEngine::isCovered) never
+     * compete for the same reason, and a site closer to a fault than the first covered distance
+     * (R = 0, on top of the epicentre) is scored at that distance. A site with no remaining
+     * fault gets PGA 0 and NO_FAULT. Square tiles of sites are
+     * spread over a work-stealing ThreadPool; each worker scores one site with a single
+     * findPGABatch call.
+     */
+    class HazardMapGenerator {
+    private:
+        FDSHAEngine Engine;
+        std::vector<Fault> Faults;
+        std::size_t TileSize;
+
+        // Faults within the horizon of a site
+        std::shared_ptr<const FaultIndex> Index;
+
+        // Per fault: whether its Mmax and F fire any rule
+        std::vector<bool> Scorable;
+
+        // Smallest covered distance, used for sites closer than it
+        double NearestDistance;
+
+        struct WorkerState;
+
+        // Scores the sites of a rectangle into row-major outputs rowStride values apart
+        void scoreSites(const SiteGrid& grid, std::size_t rowBegin, std::size_t rowEnd, std::size_t columnBegin,
+                        std::size_t columnEnd, double* pga, std::int32_t* controllingFaults, std::size_t rowStride,
+                        WorkerState& state) const;
+
+    public:
+        HazardMapGenerator(const FDSHAEngine& engine, std::vector<Fault> faults, std::size_t tileSize = 32);
+        ~HazardMapGenerator();
+
+        HazardMap generate(const SiteGrid& grid, ThreadPool& pool) const;
+
+        /**
+         * @brief Fills the incomplete tiles of a raster (all of them for a new file) over the
+         *        raster's grid, marking each as it is finished, and checkpoints at the end.
+         */
+        void generate(HazardRasterWriter& raster, ThreadPool& pool) const;
+
+        const FDSHAEngine& getEngine() const { return Engine; }
+        const std::vector<Fault>& getFaults() const { return Faults; }
+
+        /**
+         * @brief 64-bit FNV-1a hash of the catalog (every field of every fault, in order).
+         */
+        std::uint64_t getCatalogFingerprint() const;
+    };
+
+} // namespace FDSHA
+
+#endif // HAZARDMAP_H
@@ -0,0 +1,274 @@
+#include "HazardRaster.h"
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace FDSHA {
+
+    namespace {
+
+        const char RASTER_MAGIC[8] = {'F', 'D', 'S', 'H', 'A', 'H', 'M', '1'};
+        const std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+        // Layers start on page boundaries so a tile's values share no page with another section
+        const std::size_t SECTION_ALIGNMENT = 4096;
+
+        // On-disk header; the tile flags follow immediately after it
+        struct RasterFileHeader {
+            char Magic[8];
+            std::uint32_t ByteOrder;
+            std::uint32_t HeaderSize;
+            double MinLatitude;
+            double MinLongitude;
+            double LatitudeStep;
+            double LongitudeStep;
+            std::uint64_t Rows;
+            std::uint64_t Columns;
+            std::uint64_t TileSize;
+            std::uint64_t ModelFingerprint;
+            std::uint64_t CatalogFingerprint;
+            std::uint32_t Defuzzification;
+            std::uint32_t SampleCount;
+            std::uint64_t PGAOffset;
+            std::uint64_t FaultOffset;     // 0 without the controlling-fault layer
+            std::uint64_t FileSize;
+            std::uint8_t Reserved[136];
+        };
+        static_assert(sizeof(RasterFileHeader) == 256, "raster header must stay 256 bytes");
+
+        std::size_t alignUp(std::size_t offset) {
+            return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+        }
+
+        // Header of a raster with this shape: section offsets, sizes and identity
+        RasterFileHeader describe(const SiteGrid& grid, std::size_t tileSize, bool faultLayer, const RasterProvenance& provenance) {
+            std::size_t tileCount = ((grid.Rows + tileSize - 1) / tileSize) * ((grid.Columns + tileSize - 1) / tileSize);
+            std::size_t cellCount = tileCount * tileSize * tileSize;
+
+            RasterFileHeader header{};
+            std::memcpy(header.Magic, RASTER_MAGIC, sizeof(RASTER_MAGIC));
+            header.ByteOrder = BYTE_ORDER_MARK;
+            header.HeaderSize = sizeof(RasterFileHeader);
+            header.MinLatitude = grid.MinLatitude;
+            header.MinLongitude = grid.MinLongitude;
+            header.LatitudeStep = grid.LatitudeStep;
+            header.LongitudeStep = grid.LongitudeStep;
+            header.Rows = grid.Rows;
+            header.Columns = grid.Columns;
+            header.TileSize = tileSize;
+            header.ModelFingerprint = provenance.ModelFingerprint;
+            header.CatalogFingerprint = provenance.CatalogFingerprint;
+            header.Defuzzification = provenance.Defuzzification;
+            header.SampleCount = provenance.SampleCount;
+            header.PGAOffset = alignUp(sizeof(RasterFileHeader) + tileCount);
+            std::size_t end = header.PGAOffset + cellCount * sizeof(double);
+            if (faultLayer) {
+                header.FaultOffset = alignUp(end);
+                end = header.FaultOffset + cellCount * sizeof(std::int32_t);
+            }
+            header.FileSize = end;
+            return header;
+        }
+
+        // Everything but Reserved, which later versions may use for optional fields
+        bool sameRaster(const RasterFileHeader& a, const RasterFileHeader& b) {
+            return std::memcmp(&a, &b, offsetof(RasterFileHeader, Reserved)) == 0;
+        }
+
+        [[noreturn]] void fail(const std::string& what, const std::string& path) {
+            throw std::runtime_error("HazardRaster: " + what + " " + path + ": " + std::strerror(errno));
+        }
+
+    } // namespace
+
+    // --- Provenance ---
+    RasterProvenance RasterProvenance::of(const HazardMapGenerator& generator) {
+        const FDSHAEngine& engine = generator.getEngine();
+        RasterProvenance provenance;
+        provenance.ModelFingerprint = engine.getModelFingerprint();
+        provenance.CatalogFingerprint = generator.getCatalogFingerprint();
+        provenance.Defuzzification = static_cast<std::uint32_t>(engine.getDefuzzificationMethod());
+        provenance.SampleCount = static_cast<std::uint32_t>(engine.getSampleCount());
+        return provenance;
+    }
+
+    bool RasterProvenance::operator==(const RasterProvenance& other) const {
+        return ModelFingerprint == other.ModelFingerprint && CatalogFingerprint == other.CatalogFingerprint
+            && Defuzzification == other.Defuzzification && SampleCount == other.SampleCount;
+    }
+
+    // --- Reading ---
+    HazardRaster HazardRaster::open(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("HazardRaster: cannot open " + path);
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(RasterFileHeader)) {
+            ::close(fd);
+            throw std::runtime_error("HazardRaster: " + path + " is not a hazard raster");
+        }
+        std::size_t length = static_cast<std::size_t>(info.st_size);
+        void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) throw std::runtime_error("HazardRaster: cannot map " + path);
+        std::shared_ptr<const void> storage(mapping, [length](const void* p) { ::munmap(const_cast<void*>(p), length); });
+
+        const auto* header = static_cast<const RasterFileHeader*>(mapping);
+        if (std::memcmp(header->Magic, RASTER_MAGIC, sizeof(RASTER_MAGIC)) != 0 || header->ByteOrder != BYTE_ORDER_MARK
+            || header->HeaderSize != sizeof(RasterFileHeader)) {
+            throw std::runtime_error("HazardRaster: " + path + " is not a hazard raster for this platform");
+        }
+
+        HazardRaster raster;
+        raster.Grid = {header->MinLatitude, header->MinLongitude, header->LatitudeStep, header->LongitudeStep,
+                       static_cast<std::size_t>(header->Rows), static_cast<std::size_t>(header->Columns)};
+        raster.Provenance.ModelFingerprint = header->ModelFingerprint;
+        raster.Provenance.CatalogFingerprint = header->CatalogFingerprint;
+        raster.Provenance.Defuzzification = header->Defuzzification;
+        raster.Provenance.SampleCount = header->SampleCount;
+        raster.TileSize = static_cast<std::size_t>(header->TileSize);
+        if (raster.Grid.size() == 0 || raster.TileSize == 0
+            || !sameRaster(*header, describe(raster.Grid, raster.TileSize, header->FaultOffset != 0, raster.Provenance))) {
+            throw std::runtime_error("HazardRaster: " + path + " has an inconsistent header");
+        }
+        if (length != header->FileSize) throw std::runtime_error("HazardRaster: " + path + " is truncated");
+        raster.TileRows = (raster.Grid.Rows + raster.TileSize - 1) / raster.TileSize;
+        raster.TileColumns = (raster.Grid.Columns + raster.TileSize - 1) / raster.TileSize;
+
+        const char* base = static_cast<const char*>(mapping);
+        raster.Flags = reinterpret_cast<const std::uint8_t*>(base + sizeof(RasterFileHeader));
+        raster.PGA = reinterpret_cast<const double*>(base + header->PGAOffset);
+        if (header->FaultOffset != 0) raster.Faults = reinterpret_cast<const std::int32_t*>(base + header->FaultOffset);
+        raster.Storage = std::move(storage);
+        return raster;
+    }
+
+    std::size_t HazardRaster::countCompleteTiles() const {
+        std::size_t complete = 0;
+        for (std::size_t tile = 0; tile < getTileCount(); ++tile) complete += Flags[tile] != 0;
+        return complete;
+    }
+
+    // --- Writing ---
+    HazardRasterWriter::HazardRasterWriter(const std::string& path, const SiteGrid& grid, const RasterProvenance& provenance,
+                                           std::size_t tileSize, bool faultLayer, double checkpointSeconds)
+        : Path(path), Grid(grid), TileSize(tileSize),
+          CheckpointInterval(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(checkpointSeconds))) {
+        if (grid.size() == 0 || tileSize == 0) throw std::invalid_argument("HazardRasterWriter: grid and tile size must be non-empty");
+        TileRows = (grid.Rows + tileSize - 1) / tileSize;
+        TileColumns = (grid.Columns + tileSize - 1) / tileSize;
+        RasterFileHeader expected = describe(grid, tileSize, faultLayer, provenance);
+        Length = static_cast<std::size_t>(expected.FileSize);
+
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) fail("cannot open", path);
+
+        // A new file (or one this raster crashed before giving a header) is laid out from scratch;
+        // an existing raster must match exactly to be resumed
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            int error = errno;
+            ::close(fd);
+            errno = error;
+            fail("cannot stat", path);
+        }
+        bool fresh = info.st_size == 0;
+        if (!fresh) {
+            RasterFileHeader existing;
+            bool readable = info.st_size >= static_cast<off_t>(sizeof(RasterFileHeader))
+                         && ::pread(fd, &existing, sizeof(existing), 0) == static_cast<ssize_t>(sizeof(existing));
+            // Sizing the file comes before writing the header, so a run killed in between leaves
+            // exactly Length bytes behind a zero header; any other content is someone else's
+            const char zeros[sizeof(RasterFileHeader)] = {};
+            if (readable && static_cast<std::size_t>(info.st_size) == Length && std::memcmp(&existing, zeros, sizeof(zeros)) == 0) {
+                fresh = true;
+            } else if (!readable || std::memcmp(existing.Magic, RASTER_MAGIC, sizeof(RASTER_MAGIC)) != 0) {
+                ::close(fd);
+                throw std::runtime_error("HazardRaster: " + path + " is not a hazard raster");
+            } else if (!sameRaster(existing, expected)) {
+                ::close(fd);
+                throw std::runtime_error("HazardRaster: " + path + " holds a different raster (grid, tile size, layers, model or "
+                                         "catalog differ); remove it to start over");
+            } else if (static_cast<std::size_t>(info.st_size) != Length) {
+                ::close(fd);
+                throw std::runtime_error("HazardRaster: " + path + " is truncated");
+            }
+        }
+        // Sparse until written: unwritten tiles and flags read as zero
+        if (fresh && (::ftruncate(fd, 0) != 0 || ::ftruncate(fd, static_cast<off_t>(Length)) != 0)) {
+            int error = errno;
+            ::close(fd);
+            errno = error;
+            fail("cannot size", path);
+        }
+
+        Mapping = ::mmap(nullptr, Length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        int error = errno;
+        ::close(fd);
+        errno = error;
+        if (Mapping == MAP_FAILED) {
+            Mapping = nullptr;
+            fail("cannot map", path);
+        }
+
+        char* base = static_cast<char*>(Mapping);
+        Flags = reinterpret_cast<std::uint8_t*>(base + sizeof(RasterFileHeader));
+        PGA = reinterpret_cast<double*>(base + expected.PGAOffset);
+        if (faultLayer) Faults = reinterpret_cast<std::int32_t*>(base + expected.FaultOffset);
+        if (fresh) {
+            std::memcpy(base, &expected, sizeof(expected));
+            if (::msync(Mapping, SECTION_ALIGNMENT, MS_SYNC) != 0) {
+                ::munmap(Mapping, Length);
+                fail("cannot write", path);
+            }
+        }
+        LastCheckpoint = std::chrono::steady_clock::now();
+    }
+
+    HazardRasterWriter::~HazardRasterWriter() {
+        try {
+            checkpoint();
+        } catch (const std::exception&) {
+            // Unflagged tiles are recomputed on resume
+        }
+        ::munmap(Mapping, Length);
+    }
+
+    std::vector<std::size_t> HazardRasterWriter::getIncompleteTiles() const {
+        std::vector<std::size_t> tiles;
+        for (std::size_t tile = 0; tile < getTileCount(); ++tile) {
+            if (Flags[tile] == 0) tiles.push_back(tile);
+        }
+        return tiles;
+    }
+
+    void HazardRasterWriter::markTileComplete(std::size_t tile) {
+        std::lock_guard<std::mutex> lock(CheckpointMutex);
+        PendingTiles.push_back(tile);
+        if (std::chrono::steady_clock::now() - LastCheckpoint >= CheckpointInterval) checkpointLocked();
+    }
+
+    void HazardRasterWriter::checkpoint() {
+        std::lock_guard<std::mutex> lock(CheckpointMutex);
+        checkpointLocked();
+    }
+
+    void HazardRasterWriter::checkpointLocked() {
+        LastCheckpoint = std::chrono::steady_clock::now();
+        if (PendingTiles.empty()) return;
+
+        // Data first: a flag must never reach the disk ahead of its tile's values
+        if (::msync(Mapping, Length, MS_SYNC) != 0) fail("cannot sync", Path);
+        for (std::size_t tile : PendingTiles) Flags[tile] = 1;
+        std::size_t flagBytes = alignUp(sizeof(RasterFileHeader) + getTileCount());
+        if (::msync(Mapping, flagBytes, MS_SYNC) != 0) fail("cannot sync", Path);
+        PendingTiles.clear();
+    }
+
+} // namespace FDSHA
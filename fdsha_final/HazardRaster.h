@@ -0,0 +1,173 @@
+#ifndef HAZARDRASTER_H
+#define HAZARDRASTER_H
+
+#include "HazardMap.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace FDSHA {
+
+    // What a raster was computed from; a run only resumes into a file with the same provenance
+    struct RasterProvenance {
+        std::uint64_t ModelFingerprint = 0;   // FuzzyModel::fingerprint()
+        std::uint64_t CatalogFingerprint = 0; // HazardMapGenerator::getCatalogFingerprint()
+        std::uint32_t Defuzzification = 0;    // DefuzzificationMethod
+        std::uint32_t SampleCount = 0;
+
+        static RasterProvenance of(const HazardMapGenerator& generator);
+        bool operator==(const RasterProvenance& other) const;
+    };
+
+    /**
+     * @brief Read-only view of a tiled hazard raster file, mapped without copying.
+     *
+     * The file is a 256-byte header (grid geometry, tile size, provenance, layer offsets), one
+     * completion flag byte per tile, then the PGA layer and the optional controlling-fault layer.
+     * Each layer stores TileSize x TileSize values per tile, row-major within the tile, with the
+     * tiles row-major over the grid; edge tiles are padded to full size. Each layer starts on a
+     * page boundary, so a sub-region only touches the pages of its own tiles. Values are in
+     * native byte order; open() rejects files written on a platform with another order.
+     */
+    class HazardRaster {
+    public:
+        HazardRaster() = default;
+
+        /**
+         * @brief Maps a raster written by HazardRasterWriter. Throws std::runtime_error on a
+         *        missing, foreign or truncated file.
+         */
+        static HazardRaster open(const std::string& path);
+
+        const SiteGrid& getGrid() const { return Grid; }
+        const RasterProvenance& getProvenance() const { return Provenance; }
+        std::size_t getTileSize() const { return TileSize; }
+        std::size_t getTileRows() const { return TileRows; }
+        std::size_t getTileColumns() const { return TileColumns; }
+        std::size_t getTileCount() const { return TileRows * TileColumns; }
+        bool hasFaultLayer() const { return Faults != nullptr; }
+
+        std::size_t tileOf(std::size_t row, std::size_t column) const { return (row / TileSize) * TileColumns + column / TileSize; }
+
+        /**
+         * @brief Whether the tile's values were on disk when the writer last checkpointed.
+         *        Sites of incomplete tiles read as zero.
+         */
+        bool isTileComplete(std::size_t tile) const { return Flags[tile] != 0; }
+        std::size_t countCompleteTiles() const;
+
+        /**
+         * @brief The TileSize x TileSize values of a tile, pointing into the mapping.
+         */
+        const double* getTilePGA(std::size_t tile) const { return PGA + tile * TileSize * TileSize; }
+        const std::int32_t* getTileControllingFaults(std::size_t tile) const {
+            return Faults != nullptr ? Faults + tile * TileSize * TileSize : nullptr;
+        }
+
+        double getPGA(std::size_t row, std::size_t column) const { return PGA[siteOffset(row, column)]; }
+
+        /**
+         * @brief Catalog index of the controlling fault, or NO_FAULT. Requires the fault layer.
+         */
+        std::int32_t getControllingFault(std::size_t row, std::size_t column) const { return Faults[siteOffset(row, column)]; }
+
+    private:
+        SiteGrid Grid{};
+        RasterProvenance Provenance;
+        std::size_t TileSize = 0;
+        std::size_t TileRows = 0;
+        std::size_t TileColumns = 0;
+
+        // Keeps the file mapping alive; the pointers below point into it
+        std::shared_ptr<const void> Storage;
+        const std::uint8_t* Flags = nullptr;
+        const double* PGA = nullptr;
+        const std::int32_t* Faults = nullptr;
+
+        std::size_t siteOffset(std::size_t row, std::size_t column) const {
+            return tileOf(row, column) * TileSize * TileSize + (row % TileSize) * TileSize + column % TileSize;
+        }
+    };
+
+    /**
+     * @brief Writes a hazard raster through a shared read-write mapping, tile by tile.
+     *
+     * Opening a path that already holds a raster of the same grid, tile size, layers and
+     * provenance resumes it: completed tiles are kept and only the rest are computed. A path
+     * holding anything else is refused rather than overwritten.
+     *
+     * Workers fill the tiles they own directly in the mapping and report them with
+     * markTileComplete(). Completion flags only reach the file at a checkpoint, after the data
+     * pages have been synced, so a flag on disk always implies its tile's values are on disk too.
+     * A crash loses at most the tiles finished since the last checkpoint.
+     */
+    class HazardRasterWriter {
+    public:
+        /**
+         * @brief Creates or resumes the raster at path. Throws std::invalid_argument on an empty
+         *        grid or zero tile size and std::runtime_error if the file cannot be mapped or
+         *        holds a different raster.
+         */
+        HazardRasterWriter(const std::string& path, const SiteGrid& grid, const RasterProvenance& provenance,
+                           std::size_t tileSize = 256, bool faultLayer = true, double checkpointSeconds = 5.0);
+        ~HazardRasterWriter();
+
+        HazardRasterWriter(const HazardRasterWriter&) = delete;
+        HazardRasterWriter& operator=(const HazardRasterWriter&) = delete;
+
+        const SiteGrid& getGrid() const { return Grid; }
+        std::size_t getTileSize() const { return TileSize; }
+        std::size_t getTileColumns() const { return TileColumns; }
+        std::size_t getTileCount() const { return TileRows * TileColumns; }
+
+        /**
+         * @brief Tiles still to be computed, in file order (all tiles for a new file).
+         */
+        std::vector<std::size_t> getIncompleteTiles() const;
+
+        // Tile buffers in the mapping; a tile must only be written by one thread at a time
+        double* getTilePGA(std::size_t tile) const { return PGA + tile * TileSize * TileSize; }
+        std::int32_t* getTileControllingFaults(std::size_t tile) const {
+            return Faults != nullptr ? Faults + tile * TileSize * TileSize : nullptr;
+        }
+
+        /**
+         * @brief Records a fully written tile; checkpoints when checkpointSeconds have passed.
+         *        Thread-safe.
+         */
+        void markTileComplete(std::size_t tile);
+
+        /**
+         * @brief Syncs the data pages, then sets and syncs the flags of every tile marked since
+         *        the previous checkpoint. Throws std::runtime_error if the sync fails.
+         */
+        void checkpoint();
+
+    private:
+        std::string Path;
+        SiteGrid Grid;
+        std::size_t TileSize;
+        std::size_t TileRows;
+        std::size_t TileColumns;
+
+        void* Mapping = nullptr;
+        std::size_t Length = 0;
+        std::uint8_t* Flags = nullptr;
+        double* PGA = nullptr;
+        std::int32_t* Faults = nullptr;
+
+        std::mutex CheckpointMutex;
+        std::vector<std::size_t> PendingTiles;
+        std::chrono::steady_clock::duration CheckpointInterval;
+        std::chrono::steady_clock::time_point LastCheckpoint;
+
+        void checkpointLocked();
+    };
+
+} // namespace FDSHA
+
+#endif // HAZARDRASTER_H
@@ -0,0 +1,49 @@
+#ifndef INFERENCEPOLICIES_H
+#define INFERENCEPOLICIES_H
+
+#include <algorithm>
+
+namespace FDSHA {
+
+    // Operators for FDSHAEngine::findPGAWith. Each policy is a stateless type whose static
+    // apply() is inlined into the instantiated inference path, so no choice is made at run time.
+
+    // --- T-norms ---
+    // Combine the antecedent degrees of a rule (Mmax AND R AND F) and, as the implication,
+    // shape each PGA set by its rule strength.
+
+    // Zadeh AND; as implication it clips the consequent (Mamdani)
+    struct MinimumTNorm {
+        static double apply(double a, double b) { return std::min(a, b); }
+    };
+
+    // Algebraic product; as implication it scales the consequent (Larsen)
+    struct ProductTNorm {
+        static double apply(double a, double b) { return a * b; }
+    };
+
+    // --- Aggregation ---
+    // S-norms combining the strengths of rules with the same consequent and, for the center of
+    // gravity, the shaped consequents at each output point.
+
+    struct MaximumAggregation {
+        static double apply(double a, double b) { return std::max(a, b); }
+    };
+
+    // Bounded sum: every rule adds to its consequent, and degrees saturate at 1
+    struct SumAggregation {
+        static double apply(double a, double b) { return std::min(1.0, a + b); }
+    };
+
+    // --- Defuzzifiers ---
+
+    // Discrete center of gravity over the engine's sample points, O(samples x fired terms)
+    struct CenterOfGravity {};
+
+    // Sugeno-style weighted average of the PGA set centroids by their aggregated strength,
+    // O(terms); the sets are only reduced to their centroids
+    struct WeightedAverage {};
+
+} // namespace FDSHA
+
+#endif // INFERENCEPOLICIES_H
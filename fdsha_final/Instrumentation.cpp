@@ -0,0 +1,172 @@
+#include "Instrumentation.h"
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace FDSHA {
+
+    namespace {
+
+        // Every live thread's counters, plus the totals of threads that have exited
+        struct Registry {
+            std::mutex Mutex;
+            std::vector<const Instrumentation::ThreadCounters*> Live;
+            EngineStatistics Retired;
+            EngineStatistics Baseline; // subtracted by collect(), set by reset()
+        };
+
+        // Never destroyed: thread_local slots may unregister during static destruction
+        Registry& registry() {
+            static Registry* instance = new Registry();
+            return *instance;
+        }
+
+        void accumulate(EngineStatistics& totals, const Instrumentation::ThreadCounters& counters) {
+            for (std::size_t i = 0; i < COUNTER_COUNT; ++i) totals.Counters[i] += counters.Counters[i].load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < LATENCY_BUCKET_COUNT; ++i) totals.LatencyBuckets[i] += counters.LatencyBuckets[i].load(std::memory_order_relaxed);
+        }
+
+        // Raw totals since process start; the caller holds the registry lock
+        EngineStatistics sumLocked(const Registry& state) {
+            EngineStatistics totals = state.Retired;
+            for (const Instrumentation::ThreadCounters* counters : state.Live) accumulate(totals, *counters);
+            return totals;
+        }
+
+        // Exact decimal seconds; a rounded double would move bucket bounds below their true value
+        std::string seconds(std::uint64_t nanoseconds) {
+            std::string text = std::to_string(nanoseconds / 1000000000u);
+            std::uint64_t fraction = nanoseconds % 1000000000u;
+            if (fraction == 0) return text;
+            std::string digits = std::to_string(fraction);
+            digits.insert(0, 9 - digits.size(), '0');
+            digits.erase(digits.find_last_not_of('0') + 1);
+            return text + '.' + digits;
+        }
+
+        // Inclusive upper edge of latency bucket k in nanoseconds
+        std::uint64_t bucketBound(std::size_t k) {
+            return std::uint64_t{1} << k;
+        }
+
+        std::size_t lastUsedBucket(const EngineStatistics& statistics) {
+            std::size_t last = 0;
+            for (std::size_t k = 0; k < LATENCY_BUCKET_COUNT; ++k) {
+                if (statistics.LatencyBuckets[k] != 0) last = k;
+            }
+            return last;
+        }
+
+        void writeCounter(std::ostream& out, const char* name, const char* help, std::uint64_t value) {
+            out << "# HELP " << name << ' ' << help << '\n'
+                << "# TYPE " << name << " counter\n"
+                << name << ' ' << value << '\n';
+        }
+
+    } // namespace
+
+    // --- Thread Registration ---
+    Instrumentation::ThreadSlot::ThreadSlot() {
+        Registry& state = registry();
+        std::lock_guard<std::mutex> lock(state.Mutex);
+        state.Live.push_back(&Counters);
+    }
+
+    Instrumentation::ThreadSlot::~ThreadSlot() {
+        Registry& state = registry();
+        std::lock_guard<std::mutex> lock(state.Mutex);
+        accumulate(state.Retired, Counters);
+        state.Live.erase(std::find(state.Live.begin(), state.Live.end(), &Counters));
+    }
+
+    // --- Aggregation ---
+    EngineStatistics Instrumentation::collect() {
+        Registry& state = registry();
+        std::lock_guard<std::mutex> lock(state.Mutex);
+        EngineStatistics totals = sumLocked(state);
+        for (std::size_t i = 0; i < COUNTER_COUNT; ++i) totals.Counters[i] -= state.Baseline.Counters[i];
+        for (std::size_t i = 0; i < LATENCY_BUCKET_COUNT; ++i) totals.LatencyBuckets[i] -= state.Baseline.LatencyBuckets[i];
+        return totals;
+    }
+
+    void Instrumentation::reset() {
+        Registry& state = registry();
+        std::lock_guard<std::mutex> lock(state.Mutex);
+        state.Baseline = sumLocked(state);
+    }
+
+    // --- Export ---
+    std::string EngineStatistics::toJson() const {
+        std::uint64_t calls = get(Counter::Calls);
+        std::ostringstream out;
+        out << "{\n"
+            << "  \"instrumentation_enabled\": " << (INSTRUMENTATION_ENABLED ? "true" : "false") << ",\n"
+            << "  \"calls\": " << calls << ",\n"
+            << "  \"call_seconds\": " << seconds(get(Counter::CallNanoseconds)) << ",\n"
+            << "  \"stage_seconds\": {\"fuzzify\": " << seconds(get(Counter::FuzzifyNanoseconds))
+            << ", \"infer\": " << seconds(get(Counter::InferNanoseconds))
+            << ", \"defuzzify\": " << seconds(get(Counter::DefuzzifyNanoseconds)) << "},\n"
+            << "  \"fired_rules\": " << get(Counter::FiredRules) << ",\n"
+            << "  \"mean_fired_rules\": "
+            << (calls != 0 ? static_cast<double>(get(Counter::FiredRules)) / static_cast<double>(calls) : 0.0) << ",\n"
+            << "  \"defuzzify_fallbacks\": " << get(Counter::Fallbacks) << ",\n"
+            << "  \"out_of_universe\": {\"Mmax\": " << get(Counter::MmaxOutOfUniverse)
+            << ", \"R\": " << get(Counter::ROutOfUniverse)
+            << ", \"F\": " << get(Counter::FOutOfUniverse) << "},\n"
+            << "  \"batch_calls\": " << get(Counter::BatchCalls) << ",\n"
+            << "  \"batch_rows\": " << get(Counter::BatchRows) << ",\n"
+            << "  \"batch_seconds\": " << seconds(get(Counter::BatchNanoseconds)) << ",\n"
+            << "  \"latency_histogram_ns\": [";
+        std::size_t last = lastUsedBucket(*this);
+        for (std::size_t k = 0; k <= last; ++k) {
+            out << (k == 0 ? "" : ", ") << "{\"le\": ";
+            if (k + 1 == LATENCY_BUCKET_COUNT) out << "null"; else out << bucketBound(k);
+            out << ", \"count\": " << LatencyBuckets[k] << '}';
+        }
+        out << "]\n}\n";
+        return out.str();
+    }
+
+    std::string EngineStatistics::toPrometheus() const {
+        std::ostringstream out;
+        writeCounter(out, "fdsha_findpga_calls_total", "Scalar findPGA calls.", get(Counter::Calls));
+        writeCounter(out, "fdsha_fired_rules_total", "Rules fired with non-zero strength by scalar findPGA calls.",
+                     get(Counter::FiredRules));
+        writeCounter(out, "fdsha_defuzzify_fallbacks_total", "Defuzzifications of an empty aggregated output set.",
+                     get(Counter::Fallbacks));
+        writeCounter(out, "fdsha_batch_calls_total", "findPGABatch calls.", get(Counter::BatchCalls));
+        writeCounter(out, "fdsha_batch_rows_total", "Rows evaluated by findPGABatch.", get(Counter::BatchRows));
+
+        out << "# HELP fdsha_batch_seconds_total Time spent in findPGABatch.\n"
+            << "# TYPE fdsha_batch_seconds_total counter\n"
+            << "fdsha_batch_seconds_total " << seconds(get(Counter::BatchNanoseconds)) << '\n';
+
+        out << "# HELP fdsha_out_of_universe_total Crisp inputs outside their universe of discourse.\n"
+            << "# TYPE fdsha_out_of_universe_total counter\n"
+            << "fdsha_out_of_universe_total{input=\"Mmax\"} " << get(Counter::MmaxOutOfUniverse) << '\n'
+            << "fdsha_out_of_universe_total{input=\"R\"} " << get(Counter::ROutOfUniverse) << '\n'
+            << "fdsha_out_of_universe_total{input=\"F\"} " << get(Counter::FOutOfUniverse) << '\n';
+
+        out << "# HELP fdsha_stage_seconds_total Time spent per stage by scalar findPGA calls.\n"
+            << "# TYPE fdsha_stage_seconds_total counter\n"
+            << "fdsha_stage_seconds_total{stage=\"fuzzify\"} " << seconds(get(Counter::FuzzifyNanoseconds)) << '\n'
+            << "fdsha_stage_seconds_total{stage=\"infer\"} " << seconds(get(Counter::InferNanoseconds)) << '\n'
+            << "fdsha_stage_seconds_total{stage=\"defuzzify\"} " << seconds(get(Counter::DefuzzifyNanoseconds)) << '\n';
+
+        out << "# HELP fdsha_findpga_latency_seconds Latency of scalar findPGA calls.\n"
+            << "# TYPE fdsha_findpga_latency_seconds histogram\n";
+        std::uint64_t cumulative = 0;
+        for (std::size_t k = 0; k + 1 < LATENCY_BUCKET_COUNT; ++k) {
+            cumulative += LatencyBuckets[k];
+            out << "fdsha_findpga_latency_seconds_bucket{le=\"" << seconds(bucketBound(k)) << "\"} " << cumulative << '\n';
+        }
+        cumulative += LatencyBuckets[LATENCY_BUCKET_COUNT - 1];
+        out << "fdsha_findpga_latency_seconds_bucket{le=\"+Inf\"} " << cumulative << '\n'
+            << "fdsha_findpga_latency_seconds_sum " << seconds(get(Counter::CallNanoseconds)) << '\n'
+            << "fdsha_findpga_latency_seconds_count " << get(Counter::Calls) << '\n';
+        return out.str();
+    }
+
+} // namespace FDSHA
@@ -0,0 +1,143 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Engine instrumentation is compiled in only with -DFDSHA_ENABLE_INSTRUMENTATION; otherwise
+// FDSHA_INSTRUMENT(...) expands to nothing and the hot paths are unchanged.
+#ifdef FDSHA_ENABLE_INSTRUMENTATION
+#define FDSHA_INSTRUMENT(...) __VA_ARGS__
+#else
+#define FDSHA_INSTRUMENT(...)
+#endif
+
+namespace FDSHA {
+
+#ifdef FDSHA_ENABLE_INSTRUMENTATION
+    constexpr bool INSTRUMENTATION_ENABLED = true;
+#else
+    constexpr bool INSTRUMENTATION_ENABLED = false;
+#endif
+
+    // Engine event counters, summed over all threads
+    enum class Counter {
+        Calls,                // scalar findPGA calls
+        CallNanoseconds,      // total findPGA latency
+        FuzzifyNanoseconds,
+        InferNanoseconds,
+        DefuzzifyNanoseconds,
+        FiredRules,           // rules with non-zero firing strength (scalar path)
+        Fallbacks,            // defuzzifications of an empty aggregated set
+        MmaxOutOfUniverse,    // inputs outside their universe (or NaN)
+        ROutOfUniverse,
+        FOutOfUniverse,
+        BatchCalls,           // findPGABatch calls
+        BatchRows,
+        BatchNanoseconds
+    };
+    constexpr std::size_t COUNTER_COUNT = 13;
+
+    // findPGA latency histogram: bucket k counts calls with latency in (2^(k-1), 2^k] ns, so 2^k is the
+    // bucket's inclusive upper bound (Prometheus "le"); bucket 0 also holds 0 ns and the last bucket is open
+    constexpr std::size_t LATENCY_BUCKET_COUNT = 32;
+
+    /**
+     * @brief Aggregated engine counters and latency histogram.
+     */
+    struct EngineStatistics {
+        std::array<std::uint64_t, COUNTER_COUNT> Counters{};
+        std::array<std::uint64_t, LATENCY_BUCKET_COUNT> LatencyBuckets{};
+
+        std::uint64_t get(Counter counter) const { return Counters[static_cast<std::size_t>(counter)]; }
+
+        std::string toJson() const;
+
+        /**
+         * @brief Prometheus text exposition format (counters and a latency histogram).
+         */
+        std::string toPrometheus() const;
+    };
+
+    namespace Instrumentation {
+
+        /**
+         * @brief Counters of one thread. Only the owning thread writes them (plain relaxed
+         *        load + store, no read-modify-write); collect() reads them from any thread.
+         */
+        struct ThreadCounters {
+            std::array<std::atomic<std::uint64_t>, COUNTER_COUNT> Counters{};
+            std::array<std::atomic<std::uint64_t>, LATENCY_BUCKET_COUNT> LatencyBuckets{};
+        };
+
+        // Registers the calling thread's counters on first use and folds them into the totals at thread exit
+        struct ThreadSlot {
+            ThreadCounters Counters;
+            ThreadSlot();
+            ~ThreadSlot();
+        };
+
+        inline ThreadCounters& local() {
+            thread_local ThreadSlot slot;
+            return slot.Counters;
+        }
+
+        inline void bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount) {
+            counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        inline void add(Counter counter, std::uint64_t amount = 1) {
+            bump(local().Counters[static_cast<std::size_t>(counter)], amount);
+        }
+
+        inline void recordCall(std::uint64_t nanoseconds) {
+            ThreadCounters& counters = local();
+            bump(counters.Counters[static_cast<std::size_t>(Counter::Calls)], 1);
+            bump(counters.Counters[static_cast<std::size_t>(Counter::CallNanoseconds)], nanoseconds);
+            // Smallest k with nanoseconds <= 2^k: the bit width of nanoseconds - 1
+            std::uint64_t below = nanoseconds > 0 ? nanoseconds - 1 : 0;
+            std::size_t bucket = 0;
+            while (bucket + 1 < LATENCY_BUCKET_COUNT && (below >> bucket) != 0) ++bucket;
+            bump(counters.LatencyBuckets[bucket], 1);
+        }
+
+        /**
+         * @brief Sums the counters of every live and exited thread since the last reset().
+         */
+        EngineStatistics collect();
+
+        /**
+         * @brief Starts a new measurement window for collect().
+         */
+        void reset();
+
+        /**
+         * @brief Steady-clock stopwatch that charges the time since the previous lap to a counter.
+         */
+        class StageClock {
+        private:
+            using Clock = std::chrono::steady_clock;
+            Clock::time_point Start = Clock::now();
+            Clock::time_point Last = Start;
+
+        public:
+            void lap(Counter counter) {
+                Clock::time_point now = Clock::now();
+                add(counter, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - Last).count()));
+                Last = now;
+            }
+
+            std::uint64_t total() const {
+                return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Last - Start).count());
+            }
+        };
+
+    } // namespace Instrumentation
+
+} // namespace FDSHA
+
+#endif // INSTRUMENTATION_H
@@ -0,0 +1,163 @@
+#include "LoadGenerator.h"
+#include "PGAProtocol.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace FDSHA {
+
+    namespace {
+
+        using Clock = std::chrono::steady_clock;
+
+        // State of one client connection, shared by its sender and receiver threads
+        struct ClientConnection {
+            int Socket = -1;
+            std::mutex Mutex;
+            std::condition_variable SlotFree;
+            std::unordered_map<std::uint64_t, Clock::time_point> Pending; // request id -> send time
+            bool Broken = false;
+
+            std::vector<double> Latencies; // seconds, receiver thread only
+            std::uint64_t Requests = 0;
+            std::uint64_t Rows = 0;
+            std::uint64_t Errors = 0;
+            Clock::time_point LastReply;
+        };
+
+        void sendRequests(ClientConnection& client, const LoadSettings& settings, const std::vector<char>& frame,
+                          Clock::time_point deadline) {
+            RequestHeader header;
+            std::memcpy(&header, frame.data(), sizeof(header));
+            std::vector<char> request = frame;
+
+            for (std::uint64_t id = 0; Clock::now() < deadline; ++id) {
+                {
+                    std::unique_lock<std::mutex> lock(client.Mutex);
+                    client.SlotFree.wait(lock, [&] { return client.Broken || client.Pending.size() < settings.InFlight; });
+                    if (client.Broken) return;
+                    client.Pending.emplace(id, Clock::now());
+                }
+                header.RequestId = id;
+                std::memcpy(request.data(), &header, sizeof(header));
+                if (!writeFully(client.Socket, request.data(), request.size())) break;
+            }
+
+            // Wait for the outstanding replies, then let the receiver see end of stream
+            std::unique_lock<std::mutex> lock(client.Mutex);
+            client.SlotFree.wait_for(lock, std::chrono::seconds(30), [&] { return client.Broken || client.Pending.empty(); });
+            shutdown(client.Socket, SHUT_RDWR);
+        }
+
+        void receiveReplies(ClientConnection& client, std::size_t rowsPerRequest) {
+            std::vector<double> pga(rowsPerRequest);
+            ResponseHeader header;
+            while (readFully(client.Socket, &header, sizeof(header))) {
+                bool valid = header.Magic == PROTOCOL_MAGIC && header.Status == ResponseStatus::Ok && header.Rows == rowsPerRequest;
+                if (header.Magic != PROTOCOL_MAGIC || header.Rows > rowsPerRequest
+                    || !readFully(client.Socket, pga.data(), header.Rows * sizeof(double))) {
+                    ++client.Errors;
+                    break;
+                }
+                Clock::time_point now = Clock::now();
+
+                std::lock_guard<std::mutex> lock(client.Mutex);
+                auto sent = client.Pending.find(header.RequestId);
+                if (sent == client.Pending.end() || !valid) {
+                    ++client.Errors;
+                } else {
+                    client.Latencies.push_back(std::chrono::duration<double>(now - sent->second).count());
+                    ++client.Requests;
+                    client.Rows += header.Rows;
+                    client.LastReply = now;
+                }
+                if (sent != client.Pending.end()) client.Pending.erase(sent);
+                client.SlotFree.notify_one();
+            }
+
+            std::lock_guard<std::mutex> lock(client.Mutex);
+            client.Errors += client.Pending.size();
+            client.Broken = true;
+            client.SlotFree.notify_all();
+        }
+
+        double percentile(const std::vector<double>& sorted, double fraction) {
+            if (sorted.empty()) return 0.0;
+            std::size_t index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+            return sorted[std::min(index, sorted.size() - 1)];
+        }
+
+    } // namespace
+
+    LoadReport runLoad(const LoadSettings& settings) {
+        if (settings.Connections == 0 || settings.InFlight == 0 || settings.RowsPerRequest == 0
+            || settings.RowsPerRequest > MAX_REQUEST_ROWS) {
+            throw std::invalid_argument("runLoad: connections, in-flight requests and rows per request must be positive");
+        }
+
+        std::vector<ClientConnection> clients(settings.Connections);
+        try {
+            for (ClientConnection& client : clients) client.Socket = connectTo(settings.Address);
+        } catch (...) {
+            for (ClientConnection& client : clients) if (client.Socket >= 0) close(client.Socket);
+            throw;
+        }
+
+        // One request frame per connection, re-sent with a new id each time
+        std::vector<std::vector<char>> frames(settings.Connections);
+        for (std::size_t c = 0; c < settings.Connections; ++c) {
+            std::mt19937_64 generator(settings.Seed + c);
+            std::uniform_real_distribution<double> unit(0.0, 1.0);
+            std::vector<double> rows(3 * settings.RowsPerRequest);
+            for (std::size_t i = 0; i < settings.RowsPerRequest; ++i) {
+                rows[3 * i] = 4.5 + 4.0 * unit(generator);
+                rows[3 * i + 1] = 200.0 * unit(generator);
+                rows[3 * i + 2] = -0.1 + 0.2 * unit(generator);
+            }
+            RequestHeader header = {PROTOCOL_MAGIC, static_cast<std::uint32_t>(settings.RowsPerRequest), 0};
+            frames[c].resize(sizeof(header) + rows.size() * sizeof(double));
+            std::memcpy(frames[c].data(), &header, sizeof(header));
+            std::memcpy(frames[c].data() + sizeof(header), rows.data(), rows.size() * sizeof(double));
+        }
+
+        Clock::time_point start = Clock::now();
+        Clock::time_point deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(settings.Seconds));
+        std::vector<std::thread> threads;
+        for (std::size_t c = 0; c < settings.Connections; ++c) {
+            ClientConnection& client = clients[c];
+            client.LastReply = start;
+            threads.emplace_back([&client, &settings] { receiveReplies(client, settings.RowsPerRequest); });
+            threads.emplace_back([&client, &settings, &frames, c, deadline] { sendRequests(client, settings, frames[c], deadline); });
+        }
+        for (std::thread& thread : threads) thread.join();
+
+        LoadReport report;
+        std::vector<double> latencies;
+        Clock::time_point end = start;
+        for (ClientConnection& client : clients) {
+            close(client.Socket);
+            report.Requests += client.Requests;
+            report.Rows += client.Rows;
+            report.Errors += client.Errors;
+            latencies.insert(latencies.end(), client.Latencies.begin(), client.Latencies.end());
+            end = std::max(end, client.LastReply);
+        }
+        std::sort(latencies.begin(), latencies.end());
+        report.Seconds = std::chrono::duration<double>(end - start).count();
+        report.LatencyP50 = percentile(latencies, 0.50);
+        report.LatencyP99 = percentile(latencies, 0.99);
+        report.LatencyP999 = percentile(latencies, 0.999);
+        report.LatencyMax = latencies.empty() ? 0.0 : latencies.back();
+        return report;
+    }
+
+} // namespace FDSHA
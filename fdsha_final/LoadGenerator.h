@@ -0,0 +1,41 @@
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace FDSHA {
+
+    struct LoadSettings {
+        std::string Address;            // server address, see listenOn()
+        std::size_t Connections = 4;
+        std::size_t RowsPerRequest = 256;
+        std::size_t InFlight = 8;       // outstanding requests per connection
+        double Seconds = 5.0;           // sending stops after this long; replies are still awaited
+        std::uint64_t Seed = 0;         // inputs are uniform over Mmax [4.5, 8.5], R [0, 200], F [-0.1, 0.1]
+    };
+
+    struct LoadReport {
+        std::uint64_t Requests = 0;     // answered with ResponseStatus::Ok
+        std::uint64_t Rows = 0;
+        std::uint64_t Errors = 0;       // other statuses, short replies and lost connections
+        double Seconds = 0.0;           // first request to last reply
+        double LatencyP50 = 0.0;        // request round trip (seconds)
+        double LatencyP99 = 0.0;
+        double LatencyP999 = 0.0;
+        double LatencyMax = 0.0;
+    };
+
+    /**
+     * @brief Drives a PGAServer with closed-loop traffic and measures throughput and latency.
+     *
+     * Each connection keeps InFlight requests outstanding: a sender thread issues a request
+     * whenever a slot frees up and a receiver thread matches replies by id, so latency includes
+     * queueing in the server. Throws std::runtime_error if a connection cannot be opened.
+     */
+    LoadReport runLoad(const LoadSettings& settings);
+
+} // namespace FDSHA
+
+#endif // LOADGENERATOR_H
@@ -0,0 +1,214 @@
+#include "MonteCarlo.h"
+#include "Philox.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace FDSHA {
+
+    namespace {
+
+        // Samples scored per pool task (one findPGABatch call)
+        const std::size_t SAMPLE_BLOCK_SIZE = 4096;
+
+        // Scratch owned by one pool worker, padded to its own cache lines
+        struct alignas(64) WorkerState {
+            std::vector<double> Mmax;
+            std::vector<double> R;
+            std::vector<double> F;
+            std::array<std::size_t, 3> OutOfUniverse{};
+        };
+
+        double normalCdf(double x) {
+            return 0.5 * std::erfc(-x / std::sqrt(2.0));
+        }
+
+        // Acklam's rational approximation refined by one Halley step (|error| < 1e-15)
+        double inverseNormalCdf(double p) {
+            static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                       1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+            static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                       6.680131188771972e+01, -1.328068155288572e+01};
+            static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                       -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+            static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                       3.754408661907416e+00};
+            const double P_LOW = 0.02425;
+
+            if (p <= 0.0) return -INFINITY;
+            if (p >= 1.0) return INFINITY;
+
+            double x;
+            if (p < P_LOW || p > 1.0 - P_LOW) {
+                // Tails
+                double q = std::sqrt(-2.0 * std::log(p < P_LOW ? p : 1.0 - p));
+                x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5])
+                  / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+                if (p > P_LOW) x = -x;
+            } else {
+                // Central region
+                double q = p - 0.5;
+                double r = q * q;
+                x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q
+                  / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+            }
+
+            double e = normalCdf(x) - p;
+            double u = e * std::sqrt(2.0 * 3.14159265358979323846) * std::exp(0.5 * x * x);
+            return x - u / (1.0 + 0.5 * x * u);
+        }
+
+        void requireFinite(double value, const char* what) {
+            if (!std::isfinite(value)) throw std::invalid_argument(std::string("InputDistribution: ") + what + " must be finite");
+        }
+
+    } // namespace
+
+    // --- Input Distributions ---
+    InputDistribution InputDistribution::normal(double mean, double stdDev) {
+        requireFinite(mean, "mean");
+        requireFinite(stdDev, "standard deviation");
+        if (stdDev < 0.0) throw std::invalid_argument("InputDistribution: standard deviation must not be negative");
+        return {DistributionKind::Normal, mean, stdDev, 0.0, 0.0};
+    }
+
+    InputDistribution InputDistribution::truncatedNormal(double mean, double stdDev, double lower, double upper) {
+        InputDistribution distribution = normal(mean, stdDev);
+        requireFinite(lower, "lower bound");
+        requireFinite(upper, "upper bound");
+        if (lower > upper) throw std::invalid_argument("InputDistribution: lower bound exceeds upper bound");
+        distribution.Kind = DistributionKind::TruncatedNormal;
+        distribution.Lower = lower;
+        distribution.Upper = upper;
+        return distribution;
+    }
+
+    InputDistribution InputDistribution::uniform(double lower, double upper) {
+        requireFinite(lower, "lower bound");
+        requireFinite(upper, "upper bound");
+        if (lower > upper) throw std::invalid_argument("InputDistribution: lower bound exceeds upper bound");
+        return {DistributionKind::Uniform, 0.0, 0.0, lower, upper};
+    }
+
+    double InputDistribution::quantile(double u) const {
+        switch (Kind) {
+        case DistributionKind::Normal:
+            return Mean + StdDev * inverseNormalCdf(u);
+
+        case DistributionKind::TruncatedNormal: {
+            if (StdDev == 0.0) return std::clamp(Mean, Lower, Upper);
+            double alpha = (Lower - Mean) / StdDev;
+            double beta = (Upper - Mean) / StdDev;
+            // Invert in the lower half, where the CDF keeps its relative precision
+            bool mirrored = alpha > 0.0;
+            if (mirrored) {
+                std::swap(alpha, beta);
+                alpha = -alpha;
+                beta = -beta;
+            }
+            double low = normalCdf(alpha);
+            double z = std::clamp(inverseNormalCdf(low + u * (normalCdf(beta) - low)), alpha, beta);
+            return Mean + StdDev * (mirrored ? -z : z);
+        }
+
+        case DistributionKind::Uniform:
+        default:
+            return Lower + u * (Upper - Lower);
+        }
+    }
+
+    // --- Simulation ---
+    MonteCarloSimulator::MonteCarloSimulator(const FDSHAEngine& engine, const InputDistribution& mmax,
+                                             const InputDistribution& r, const InputDistribution& f)
+        : Engine(engine), MmaxDistribution(mmax), RDistribution(r), FDistribution(f) {}
+
+    std::vector<double> MonteCarloSimulator::simulate(std::size_t count, std::uint64_t seed, ThreadPool& pool,
+                                                      std::array<std::size_t, 3>* outOfUniverse) const {
+        std::vector<double> pga(count);
+        std::vector<WorkerState> workers(pool.size());
+        const Philox4x32 generator(seed);
+
+        pool.run((count + SAMPLE_BLOCK_SIZE - 1) / SAMPLE_BLOCK_SIZE, [&](std::size_t block, std::size_t worker) {
+            WorkerState& state = workers[worker];
+            std::size_t begin = block * SAMPLE_BLOCK_SIZE;
+            std::size_t n = std::min(SAMPLE_BLOCK_SIZE, count - begin);
+            state.Mmax.resize(n);
+            state.R.resize(n);
+            state.F.resize(n);
+
+            // Counter (i, 0) feeds Mmax and R of sample i, counter (i, 1) feeds F
+            for (std::size_t i = 0; i < n; ++i) {
+                Philox4x32::Block first = generator(begin + i, 0);
+                Philox4x32::Block second = generator(begin + i, 1);
+                state.Mmax[i] = MmaxDistribution.quantile(Philox4x32::toUnitInterval(first[0], first[1]));
+                state.R[i] = RDistribution.quantile(Philox4x32::toUnitInterval(first[2], first[3]));
+                state.F[i] = FDistribution.quantile(Philox4x32::toUnitInterval(second[0], second[1]));
+            }
+            Engine.findPGABatch(state.Mmax.data(), state.R.data(), state.F.data(), pga.data() + begin, n);
+
+            for (std::size_t i = 0; i < n; ++i) {
+                bool mmaxOutside = !Engine.isCovered(InputAxis::Magnitude, state.Mmax[i]);
+                bool rOutside = !Engine.isCovered(InputAxis::Distance, state.R[i]);
+                bool fOutside = !Engine.isCovered(InputAxis::FaultType, state.F[i]);
+                state.OutOfUniverse[0] += mmaxOutside;
+                state.OutOfUniverse[1] += rOutside;
+                state.OutOfUniverse[2] += fOutside;
+                if (mmaxOutside || rOutside || fOutside) pga[begin + i] = std::numeric_limits<double>::quiet_NaN();
+            }
+        });
+
+        if (outOfUniverse != nullptr) {
+            *outOfUniverse = {};
+            for (const WorkerState& state : workers) {
+                for (std::size_t axis = 0; axis < 3; ++axis) (*outOfUniverse)[axis] += state.OutOfUniverse[axis];
+            }
+        }
+        return pga;
+    }
+
+    MonteCarloSummary MonteCarloSimulator::run(const MonteCarloSettings& settings, ThreadPool& pool) const {
+        if (settings.Samples == 0) throw std::invalid_argument("MonteCarloSimulator: sample count must be positive");
+        for (double percentile : settings.Percentiles) {
+            if (!(percentile >= 0.0 && percentile <= 100.0)) throw std::invalid_argument("MonteCarloSimulator: percentiles must lie in [0, 100]");
+        }
+
+        MonteCarloSummary summary;
+        std::vector<double> pga = simulate(settings.Samples, settings.Seed, pool, &summary.OutOfUniverse);
+        summary.Samples = pga.size();
+        pga.erase(std::remove_if(pga.begin(), pga.end(), [](double value) { return std::isnan(value); }), pga.end());
+        summary.Rejected = summary.Samples - pga.size();
+        if (pga.empty()) {
+            throw std::runtime_error("MonteCarloSimulator: every sample has an input outside the model's universes");
+        }
+
+        // Moments and exceedances in sample order, so the sums do not depend on the schedule
+        double sum = 0.0;
+        std::array<std::size_t, PGA_VERDICT_THRESHOLDS.size()> exceeding{};
+        for (double value : pga) {
+            sum += value;
+            for (std::size_t t = 0; t < PGA_VERDICT_THRESHOLDS.size(); ++t) exceeding[t] += value >= PGA_VERDICT_THRESHOLDS[t];
+        }
+        summary.Mean = sum / static_cast<double>(pga.size());
+        double squares = 0.0;
+        for (double value : pga) squares += (value - summary.Mean) * (value - summary.Mean);
+        summary.StdDev = pga.size() > 1 ? std::sqrt(squares / static_cast<double>(pga.size() - 1)) : 0.0;
+        for (std::size_t t = 0; t < PGA_VERDICT_THRESHOLDS.size(); ++t) {
+            summary.Exceedance[t] = static_cast<double>(exceeding[t]) / static_cast<double>(pga.size());
+        }
+
+        std::sort(pga.begin(), pga.end());
+        summary.Min = pga.front();
+        summary.Max = pga.back();
+        for (double percentile : settings.Percentiles) {
+            double position = percentile / 100.0 * static_cast<double>(pga.size() - 1);
+            std::size_t below = static_cast<std::size_t>(position);
+            std::size_t above = std::min(below + 1, pga.size() - 1);
+            double fraction = position - static_cast<double>(below);
+            summary.Percentiles.push_back(pga[below] + fraction * (pga[above] - pga[below]));
+        }
+        return summary;
+    }
+
+} // namespace FDSHA
@@ -0,0 +1,107 @@
+#ifndef MONTECARLO_H
+#define MONTECARLO_H
+
+#include "FDSHAEngine.h"
+#include "HazardLevels.h"
+#include "ThreadPool.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace FDSHA {
+
+    enum class DistributionKind { Normal, TruncatedNormal, Uniform };
+
+    /**
+     * @brief Probability distribution of one uncertain crisp input.
+     *
+     * Samples are drawn by inverse transform, so each one costs exactly one uniform variate and
+     * a sample depends only on its position in the random stream.
+     */
+    struct InputDistribution {
+        DistributionKind Kind = DistributionKind::Uniform;
+        double Mean = 0.0;   // Normal, TruncatedNormal
+        double StdDev = 0.0; // Normal, TruncatedNormal
+        double Lower = 0.0;  // TruncatedNormal, Uniform
+        double Upper = 0.0;  // TruncatedNormal, Uniform
+
+        static InputDistribution normal(double mean, double stdDev);
+        static InputDistribution truncatedNormal(double mean, double stdDev, double lower, double upper);
+        static InputDistribution uniform(double lower, double upper);
+
+        /**
+         * @brief A fixed value (a uniform distribution of zero width).
+         */
+        static InputDistribution constant(double value) { return uniform(value, value); }
+
+        /**
+         * @brief Inverse CDF at u in (0, 1).
+         */
+        double quantile(double u) const;
+    };
+
+    struct MonteCarloSettings {
+        std::size_t Samples = 100000;
+        std::uint64_t Seed = 0;
+        std::vector<double> Percentiles = {5.0, 16.0, 50.0, 84.0, 95.0};
+    };
+
+    /**
+     * @brief Distribution of the PGA over the sampled inputs.
+     */
+    struct MonteCarloSummary {
+        std::size_t Samples = 0;                     // drawn
+        std::size_t Rejected = 0;                    // with an input outside its universe, excluded below
+        std::array<std::size_t, 3> OutOfUniverse{};  // rejections by input (Mmax, R, F); a sample may count twice
+        // Over the Samples - Rejected scored samples
+        double Mean = 0.0;
+        double StdDev = 0.0;
+        double Min = 0.0;
+        double Max = 0.0;
+        std::vector<double> Percentiles;                                   // at MonteCarloSettings::Percentiles
+        std::array<double, PGA_VERDICT_THRESHOLDS.size()> Exceedance{};   // P(PGA >= PGA_VERDICT_THRESHOLDS[i])
+    };
+
+    /**
+     * @brief Propagates input uncertainty through the engine by Monte Carlo sampling.
+     *
+     * Sample i takes its inputs from Philox4x32 counter i under the run's seed, so the samples
+     * (and every statistic) are identical for any thread count or schedule. Samples are scored
+     * in blocks on a ThreadPool; each block is one findPGABatch call, so fuzzification and
+     * inference run in the SIMD kernels rather than one scalar findPGA per sample.
+     *
+     * A sample with an input no set covers (FDSHAEngine::isCovered: outside the universe, e.g.
+     * the tail of a normal distribution) would only get the engine's empty-set fallback, which
+     * says nothing about the hazard. Such samples are rejected: counted in the summary and left
+     * out of every statistic. Truncated or uniform distributions inside the universes avoid them.
+     */
+    class MonteCarloSimulator {
+    private:
+        FDSHAEngine Engine;
+        InputDistribution MmaxDistribution;
+        InputDistribution RDistribution;
+        InputDistribution FDistribution;
+
+    public:
+        MonteCarloSimulator(const FDSHAEngine& engine, const InputDistribution& mmax, const InputDistribution& r,
+                            const InputDistribution& f);
+
+        /**
+         * @brief PGA of samples [0, count), in sample order; NaN for rejected samples. When
+         *        outOfUniverse is given, it receives the rejections per input (Mmax, R, F).
+         */
+        std::vector<double> simulate(std::size_t count, std::uint64_t seed, ThreadPool& pool,
+                                     std::array<std::size_t, 3>* outOfUniverse = nullptr) const;
+
+        /**
+         * @brief Runs settings.Samples samples and summarizes the accepted ones (percentiles by
+         *        linear interpolation between order statistics). Throws std::runtime_error if
+         *        every sample is rejected.
+         */
+        MonteCarloSummary run(const MonteCarloSettings& settings, ThreadPool& pool) const;
+    };
+
+} // namespace FDSHA
+
+#endif // MONTECARLO_H
@@ -0,0 +1,200 @@
+#include "PGACache.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace FDSHA {
+
+    namespace {
+
+        // Quantized values beyond this magnitude bypass the cache (llround would overflow)
+        const double MAX_KEY = 4.0e18;
+
+        std::size_t roundUpToPowerOfTwo(std::size_t n) {
+            std::size_t power = 1;
+            while (power < n) power <<= 1;
+            return power;
+        }
+
+        // 64-bit finalizer of MurmurHash3 over a combination of the three keys
+        std::uint64_t hashKeys(std::int64_t mmax, std::int64_t r, std::int64_t f) {
+            std::uint64_t h = static_cast<std::uint64_t>(mmax) * 0x9E3779B97F4A7C15ull;
+            h ^= static_cast<std::uint64_t>(r) * 0xC2B2AE3D27D4EB4Full;
+            h ^= static_cast<std::uint64_t>(f) * 0x165667B19E3779F9ull;
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCDull;
+            h ^= h >> 33;
+            h *= 0xC4CEB9FE1A85EC53ull;
+            h ^= h >> 33;
+            return h;
+        }
+
+    } // namespace
+
+    // --- Quantization ---
+    PGACache::Quantizer::Quantizer(double resolution) : Step(resolution) {
+        if (!(resolution >= 0.0) || !std::isfinite(resolution)) {
+            throw std::invalid_argument("PGACache: resolutions must be finite and non-negative");
+        }
+        if (resolution == 0.0) return;
+        Scale = 1.0 / resolution;
+        double rounded = std::round(Scale);
+        if (rounded >= 1.0 && std::fabs(Scale - rounded) <= 1e-9 * rounded) {
+            Scale = rounded;
+            Integral = true;
+        }
+    }
+
+    bool PGACache::Quantizer::key(double value, std::int64_t& key) const {
+        if (Step == 0.0) {
+            if (std::isnan(value)) return false;
+            std::memcpy(&key, &value, sizeof(key));
+            return true;
+        }
+        double scaled = value * Scale;
+        if (!(std::fabs(scaled) < MAX_KEY)) return false; // also rejects NaN
+        key = std::llround(scaled);
+        return true;
+    }
+
+    double PGACache::Quantizer::value(std::int64_t key) const {
+        if (Step == 0.0) {
+            double value;
+            std::memcpy(&value, &key, sizeof(value));
+            return value;
+        }
+        return Integral ? static_cast<double>(key) / Scale : static_cast<double>(key) * Step;
+    }
+
+    // --- Construction ---
+    PGACache::PGACache(const FDSHAEngine& engine, const CacheSettings& settings)
+        : Engine(engine), MmaxQuantizer(settings.MmaxResolution), RQuantizer(settings.RResolution),
+          FQuantizer(settings.FResolution) {
+        if (settings.Capacity == 0 || settings.Shards == 0) {
+            throw std::invalid_argument("PGACache: capacity and shard count must be positive");
+        }
+        std::size_t shardCount = roundUpToPowerOfTwo(settings.Shards);
+        SlotsPerShard = roundUpToPowerOfTwo(std::max<std::size_t>((settings.Capacity + shardCount - 1) / shardCount, PROBE_LIMIT));
+        for (std::size_t i = 0; i < shardCount; ++i) {
+            Shards.push_back(std::make_unique<Shard>());
+            Shards.back()->Slots.reset(new Slot[SlotsPerShard]);
+        }
+        clear();
+    }
+
+    void PGACache::clear() {
+        const Slot empty = {0, 0, 0, std::numeric_limits<double>::quiet_NaN()};
+        for (const auto& shard : Shards) {
+            std::lock_guard<std::mutex> lock(shard->Mutex);
+            std::fill(shard->Slots.get(), shard->Slots.get() + SlotsPerShard, empty);
+            shard->Hits = shard->Misses = shard->Evictions = 0;
+        }
+        Bypasses.store(0);
+    }
+
+    CacheStatistics PGACache::getStatistics() const {
+        CacheStatistics statistics;
+        for (const auto& shard : Shards) {
+            std::lock_guard<std::mutex> lock(shard->Mutex);
+            statistics.Hits += shard->Hits;
+            statistics.Misses += shard->Misses;
+            statistics.Evictions += shard->Evictions;
+            for (std::size_t i = 0; i < SlotsPerShard; ++i) statistics.Entries += !std::isnan(shard->Slots[i].PGA);
+        }
+        statistics.Bypasses = Bypasses.load();
+        return statistics;
+    }
+
+    // --- Table ---
+    bool PGACache::makeKey(double mmaxInput, double rInput, double fInput, Key& key) const {
+        return MmaxQuantizer.key(mmaxInput, key.Mmax) && RQuantizer.key(rInput, key.R) && FQuantizer.key(fInput, key.F);
+    }
+
+    bool PGACache::lookup(Shard& shard, std::uint64_t hash, const Key& key, double& pga) const {
+        std::size_t mask = SlotsPerShard - 1;
+        for (std::size_t probe = 0; probe < PROBE_LIMIT; ++probe) {
+            const Slot& slot = shard.Slots[(hash + probe) & mask];
+            if (std::isnan(slot.PGA)) break; // slots are never emptied, so the key is not further on
+            if (slot.Mmax == key.Mmax && slot.R == key.R && slot.F == key.F) {
+                pga = slot.PGA;
+                ++shard.Hits;
+                return true;
+            }
+        }
+        ++shard.Misses;
+        return false;
+    }
+
+    void PGACache::insert(Shard& shard, std::uint64_t hash, const Key& key, double pga) const {
+        std::size_t mask = SlotsPerShard - 1;
+        for (std::size_t probe = 0; probe < PROBE_LIMIT; ++probe) {
+            Slot& slot = shard.Slots[(hash + probe) & mask];
+            // Another thread may have inserted the same key since our lookup; its value is identical
+            if (std::isnan(slot.PGA) || (slot.Mmax == key.Mmax && slot.R == key.R && slot.F == key.F)) {
+                slot = {key.Mmax, key.R, key.F, pga};
+                return;
+            }
+        }
+        shard.Slots[hash & mask] = {key.Mmax, key.R, key.F, pga};
+        ++shard.Evictions;
+    }
+
+    // --- Queries ---
+    double PGACache::findPGA(double mmaxInput, double rInput, double fInput) const {
+        Key key;
+        if (!makeKey(mmaxInput, rInput, fInput, key)) {
+            Bypasses.fetch_add(1, std::memory_order_relaxed);
+            return Engine.findPGA(mmaxInput, rInput, fInput);
+        }
+        std::uint64_t hash = hashKeys(key.Mmax, key.R, key.F);
+        Shard& shard = shardOf(hash);
+        double pga;
+        {
+            std::lock_guard<std::mutex> lock(shard.Mutex);
+            if (lookup(shard, hash, key, pga)) return pga;
+        }
+
+        pga = Engine.findPGA(MmaxQuantizer.value(key.Mmax), RQuantizer.value(key.R), FQuantizer.value(key.F));
+        std::lock_guard<std::mutex> lock(shard.Mutex);
+        insert(shard, hash, key, pga);
+        return pga;
+    }
+
+    void PGACache::findPGABatch(const double* mmaxInputs, const double* rInputs, const double* fInputs,
+                                double* pgaOutputs, std::size_t count) const {
+        // Misses are scored with the scalar findPGA, so a slot holds the same value whichever
+        // path filled it; only bypasses, which never enter the table, go through the batch kernel
+        std::vector<std::size_t> bypasses;
+        std::vector<double> mmax, r, f;
+
+        for (std::size_t i = 0; i < count; ++i) {
+            Key key;
+            if (!makeKey(mmaxInputs[i], rInputs[i], fInputs[i], key)) {
+                bypasses.push_back(i);
+                mmax.push_back(mmaxInputs[i]);
+                r.push_back(rInputs[i]);
+                f.push_back(fInputs[i]);
+                continue;
+            }
+            std::uint64_t hash = hashKeys(key.Mmax, key.R, key.F);
+            Shard& shard = shardOf(hash);
+            {
+                std::lock_guard<std::mutex> lock(shard.Mutex);
+                if (lookup(shard, hash, key, pgaOutputs[i])) continue;
+            }
+            double pga = Engine.findPGA(MmaxQuantizer.value(key.Mmax), RQuantizer.value(key.R), FQuantizer.value(key.F));
+            pgaOutputs[i] = pga;
+            std::lock_guard<std::mutex> lock(shard.Mutex);
+            insert(shard, hash, key, pga);
+        }
+        if (bypasses.empty()) return;
+
+        Bypasses.fetch_add(bypasses.size(), std::memory_order_relaxed);
+        std::vector<double> pga(bypasses.size());
+        Engine.findPGABatch(mmax.data(), r.data(), f.data(), pga.data(), pga.size());
+        for (std::size_t j = 0; j < bypasses.size(); ++j) pgaOutputs[bypasses[j]] = pga[j];
+    }
+
+} // namespace FDSHA
@@ -0,0 +1,138 @@
+#ifndef PGACACHE_H
+#define PGACACHE_H
+
+#include "FDSHAEngine.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace FDSHA {
+
+    struct CacheSettings {
+        // Quantization step of each input (0 = key on the exact value)
+        double MmaxResolution = 0.01;
+        double RResolution = 0.01;        // km
+        double FResolution = 0.001;
+        std::size_t Capacity = 1u << 20;  // entries over all shards (rounded up to powers of two)
+        std::size_t Shards = 64;          // independently locked tables (rounded up to a power of two)
+    };
+
+    // Totals since construction or the last clear()
+    struct CacheStatistics {
+        std::uint64_t Hits = 0;
+        std::uint64_t Misses = 0;     // computed by the engine and inserted
+        std::uint64_t Evictions = 0;  // inserts that overwrote another key
+        std::uint64_t Bypasses = 0;   // NaN or out-of-range inputs, computed without the cache
+        std::uint64_t Entries = 0;    // occupied slots
+
+        double hitRate() const {
+            std::uint64_t lookups = Hits + Misses;
+            return lookups == 0 ? 0.0 : static_cast<double>(Hits) / static_cast<double>(lookups);
+        }
+    };
+
+    /**
+     * @brief Bounded memo table in front of an engine for workloads that repeat (Mmax, R, F).
+     *
+     * Each input is snapped to the nearest multiple of its resolution and the PGA is computed at
+     * that grid point, so every query that shares a key gets the same value no matter which
+     * thread computed it first. When 1 / resolution is an integer (0.1, 0.01, ...), grid points
+     * are formed as key / (1 / resolution), which is the double nearest the decimal value: inputs
+     * with no more decimals than the resolution get exactly findPGA of their own value. Both
+     * findPGA and findPGABatch fill misses with the engine's scalar findPGA.
+     *
+     * Keys hash into one of Shards open-addressing tables of 32-byte slots, each behind its own
+     * mutex. A lookup probes at most PROBE_LIMIT neighbouring slots (two or three cache lines);
+     * when all are taken, the insert overwrites the home slot. Locks are held only for the probe,
+     * never while the engine runs, so two threads missing on the same key both compute it.
+     *
+     * The cache owns a copy of the engine; build a new cache after swapping the model.
+     */
+    class PGACache {
+    public:
+        /**
+         * @brief Throws std::invalid_argument on a negative or non-finite resolution or a zero
+         *        capacity or shard count.
+         */
+        PGACache(const FDSHAEngine& engine, const CacheSettings& settings = CacheSettings());
+
+        PGACache(const PGACache&) = delete;
+        PGACache& operator=(const PGACache&) = delete;
+
+        /**
+         * @brief Engine PGA at the grid point of the inputs, from the table when present.
+         */
+        double findPGA(double mmaxInput, double rInput, double fInput) const;
+
+        /**
+         * @brief findPGA over structure-of-arrays inputs. Misses are computed one by one like
+         *        findPGA; rows that bypass the cache go to the engine in one findPGABatch call.
+         */
+        void findPGABatch(const double* mmaxInputs, const double* rInputs, const double* fInputs,
+                          double* pgaOutputs, std::size_t count) const;
+
+        /**
+         * @brief Empties the table and resets the statistics.
+         */
+        void clear();
+
+        CacheStatistics getStatistics() const;
+
+        const FDSHAEngine& getEngine() const { return Engine; }
+        std::size_t getCapacity() const { return Shards.size() * SlotsPerShard; }
+
+        static constexpr std::size_t PROBE_LIMIT = 8;
+
+    private:
+        // Quantized inputs; a NaN PGA marks an empty slot
+        struct Slot {
+            std::int64_t Mmax;
+            std::int64_t R;
+            std::int64_t F;
+            double PGA;
+        };
+
+        struct alignas(64) Shard {
+            std::mutex Mutex;
+            std::unique_ptr<Slot[]> Slots;
+            std::uint64_t Hits = 0;
+            std::uint64_t Misses = 0;
+            std::uint64_t Evictions = 0;
+        };
+
+        // Maps an input to its key and back to the grid point the PGA is computed at
+        struct Quantizer {
+            double Step = 0.0;        // resolution (0 = exact)
+            double Scale = 0.0;       // 1 / Step
+            bool Integral = false;    // Scale is an integer, so grid points are key / Scale
+
+            explicit Quantizer(double resolution);
+
+            bool key(double value, std::int64_t& key) const;
+            double value(std::int64_t key) const;
+        };
+
+        struct Key {
+            std::int64_t Mmax, R, F;
+        };
+
+        FDSHAEngine Engine;
+        Quantizer MmaxQuantizer, RQuantizer, FQuantizer;
+        std::size_t SlotsPerShard;
+        std::vector<std::unique_ptr<Shard>> Shards;
+        mutable std::atomic<std::uint64_t> Bypasses{0};
+
+        bool makeKey(double mmaxInput, double rInput, double fInput, Key& key) const;
+        Shard& shardOf(std::uint64_t hash) const { return *Shards[(hash >> 40) & (Shards.size() - 1)]; }
+
+        // Both expect the shard's mutex to be held
+        bool lookup(Shard& shard, std::uint64_t hash, const Key& key, double& pga) const;
+        void insert(Shard& shard, std::uint64_t hash, const Key& key, double pga) const;
+    };
+
+} // namespace FDSHA
+
+#endif // PGACACHE_H
@@ -0,0 +1,131 @@
+#include "PGAProtocol.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace FDSHA {
+
+    namespace {
+
+        // Resolved form of an address string
+        struct SocketAddress {
+            sockaddr_storage Storage{};
+            socklen_t Length = 0;
+            bool Unix = false;
+            std::string Path;
+        };
+
+        [[noreturn]] void fail(const std::string& what, const std::string& address) {
+            throw std::runtime_error(what + " " + address + ": " + std::strerror(errno));
+        }
+
+        SocketAddress resolve(const std::string& address) {
+            SocketAddress resolved;
+            if (address.compare(0, 5, "unix:") == 0) {
+                resolved.Unix = true;
+                resolved.Path = address.substr(5);
+                sockaddr_un* un = reinterpret_cast<sockaddr_un*>(&resolved.Storage);
+                if (resolved.Path.empty() || resolved.Path.size() >= sizeof(un->sun_path)) {
+                    throw std::runtime_error("Invalid socket path in " + address);
+                }
+                un->sun_family = AF_UNIX;
+                std::memcpy(un->sun_path, resolved.Path.c_str(), resolved.Path.size() + 1);
+                resolved.Length = sizeof(sockaddr_un);
+                return resolved;
+            }
+
+            if (address.compare(0, 4, "tcp:") == 0) {
+                std::string rest = address.substr(4);
+                std::size_t colon = rest.rfind(':');
+                std::string host = colon == std::string::npos ? "127.0.0.1" : rest.substr(0, colon);
+                std::string port = colon == std::string::npos ? rest : rest.substr(colon + 1);
+                char* end = nullptr;
+                unsigned long number = std::strtoul(port.c_str(), &end, 10);
+                sockaddr_in* in = reinterpret_cast<sockaddr_in*>(&resolved.Storage);
+                in->sin_family = AF_INET;
+                in->sin_port = htons(static_cast<std::uint16_t>(number));
+                if (port.empty() || *end != '\0' || number > 65535 || inet_pton(AF_INET, host.c_str(), &in->sin_addr) != 1) {
+                    throw std::runtime_error("Invalid TCP address " + address + " (expected tcp:PORT or tcp:IPV4:PORT)");
+                }
+                resolved.Length = sizeof(sockaddr_in);
+                return resolved;
+            }
+
+            throw std::runtime_error("Unknown address " + address + " (expected unix:PATH or tcp:[HOST:]PORT)");
+        }
+
+        // Small frames go out immediately instead of waiting for Nagle's algorithm
+        void disableNagle(int fd, const SocketAddress& resolved) {
+            if (resolved.Unix) return;
+            int on = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        }
+
+    } // namespace
+
+    int listenOn(const std::string& address) {
+        SocketAddress resolved = resolve(address);
+        int fd = socket(resolved.Storage.ss_family, SOCK_STREAM, 0);
+        if (fd < 0) fail("Cannot create a socket for", address);
+
+        if (resolved.Unix) {
+            unlink(resolved.Path.c_str());
+        } else {
+            int on = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        }
+        if (bind(fd, reinterpret_cast<const sockaddr*>(&resolved.Storage), resolved.Length) != 0 || listen(fd, SOMAXCONN) != 0) {
+            int error = errno;
+            close(fd);
+            errno = error;
+            fail("Cannot listen on", address);
+        }
+        return fd;
+    }
+
+    int connectTo(const std::string& address) {
+        SocketAddress resolved = resolve(address);
+        int fd = socket(resolved.Storage.ss_family, SOCK_STREAM, 0);
+        if (fd < 0) fail("Cannot create a socket for", address);
+        if (connect(fd, reinterpret_cast<const sockaddr*>(&resolved.Storage), resolved.Length) != 0) {
+            int error = errno;
+            close(fd);
+            errno = error;
+            fail("Cannot connect to", address);
+        }
+        disableNagle(fd, resolved);
+        return fd;
+    }
+
+    bool readFully(int fd, void* data, std::size_t size) {
+        char* p = static_cast<char*>(data);
+        while (size > 0) {
+            ssize_t n = read(fd, p, size);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            p += n;
+            size -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    bool writeFully(int fd, const void* data, std::size_t size) {
+        const char* p = static_cast<const char*>(data);
+        while (size > 0) {
+            // MSG_NOSIGNAL: a vanished peer is an error return, not SIGPIPE
+            ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            p += n;
+            size -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+} // namespace FDSHA
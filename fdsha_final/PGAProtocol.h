@@ -0,0 +1,67 @@
+#ifndef PGAPROTOCOL_H
+#define PGAPROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace FDSHA {
+
+    // --- Wire Format ---
+    // Frames are a fixed header followed by a payload, in the host's byte order (local IPC only).
+    // A request carries Rows x (Mmax, R, F) doubles; its response carries Rows PGA doubles and
+    // echoes RequestId. Responses on one connection may arrive out of request order, so clients
+    // match them by id and must keep reading responses while they send.
+
+    constexpr std::uint32_t PROTOCOL_MAGIC = 0x48534446; // "FDSH"
+
+    // Largest request a server accepts; bigger ones are answered with ResponseStatus::TooLarge
+    constexpr std::uint32_t MAX_REQUEST_ROWS = 1u << 20;
+
+    struct RequestHeader {
+        std::uint32_t Magic;
+        std::uint32_t Rows;
+        std::uint64_t RequestId;
+    };
+
+    enum class ResponseStatus : std::uint32_t {
+        Ok = 0,
+        TooLarge = 1 // the connection is closed after this response
+    };
+
+    struct ResponseHeader {
+        std::uint32_t Magic;
+        ResponseStatus Status;
+        std::uint64_t RequestId;
+        std::uint32_t Rows;      // PGA values that follow (0 unless Status is Ok)
+        std::uint32_t Reserved;
+    };
+
+    static_assert(sizeof(RequestHeader) == 16 && sizeof(ResponseHeader) == 24, "Wire headers must have no padding");
+
+    // --- Sockets ---
+
+    /**
+     * @brief Binds and listens on "unix:PATH", "tcp:PORT" (127.0.0.1) or "tcp:HOST:PORT".
+     *        A stale socket file at PATH is replaced. Throws std::runtime_error on failure.
+     */
+    int listenOn(const std::string& address);
+
+    /**
+     * @brief Connects to an address in the listenOn() format. Throws std::runtime_error on failure.
+     */
+    int connectTo(const std::string& address);
+
+    /**
+     * @brief Reads exactly size bytes; false on end of stream or error.
+     */
+    bool readFully(int fd, void* data, std::size_t size);
+
+    /**
+     * @brief Writes exactly size bytes; false if the peer is gone.
+     */
+    bool writeFully(int fd, const void* data, std::size_t size);
+
+} // namespace FDSHA
+
+#endif // PGAPROTOCOL_H
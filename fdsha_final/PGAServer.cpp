@@ -0,0 +1,238 @@
+#include "PGAServer.h"
+#include <algorithm>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace FDSHA {
+
+    namespace {
+
+        // A client that stops reading for this long is disconnected instead of stalling a worker
+        const int SEND_TIMEOUT_SECONDS = 10;
+
+        // A client that stalls this long inside a request payload is disconnected instead of
+        // holding the queue capacity reserved for it
+        const int PAYLOAD_TIMEOUT_SECONDS = 10;
+
+        void setReceiveTimeout(int socket, int seconds) {
+            timeval timeout = {seconds, 0};
+            setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        }
+
+    } // namespace
+
+    // --- Connections ---
+    PGAServer::Connection::~Connection() {
+        close(Socket);
+    }
+
+    PGAServer::PGAServer(EngineHandle& engines, const ServerSettings& settings) : Engines(engines), Settings(settings) {
+        Settings.BatchRows = std::max<std::size_t>(Settings.BatchRows, 1);
+        Settings.QueueRows = std::max(Settings.QueueRows, Settings.BatchRows);
+    }
+
+    PGAServer::~PGAServer() {
+        stop();
+    }
+
+    void PGAServer::start() {
+        ListenSocket = listenOn(Settings.Address);
+        std::size_t workerCount = Settings.Workers != 0 ? Settings.Workers : std::max(1u, std::thread::hardware_concurrency());
+        for (std::size_t i = 0; i < workerCount; ++i) Workers.emplace_back([this] { runWorker(); });
+        Acceptor = std::thread([this] { acceptConnections(); });
+    }
+
+    void PGAServer::stop() {
+        if (Stopping.exchange(true)) return;
+        if (Acceptor.joinable()) Acceptor.join();
+        if (ListenSocket >= 0) {
+            close(ListenSocket);
+            if (Settings.Address.compare(0, 5, "unix:") == 0) unlink(Settings.Address.c_str() + 5);
+        }
+
+        // Wake the readers; responses can still be written until the workers have drained the queue
+        {
+            std::lock_guard<std::mutex> lock(ConnectionsMutex);
+            for (const auto& connection : Connections) shutdown(connection->Socket, SHUT_RD);
+        }
+        {
+            std::lock_guard<std::mutex> lock(QueueMutex);
+            QueueClosed = true;
+        }
+        NotEmpty.notify_all();
+        NotFull.notify_all();
+        for (std::thread& worker : Workers) worker.join();
+        Workers.clear();
+
+        std::lock_guard<std::mutex> lock(ConnectionsMutex);
+        for (const auto& connection : Connections) connection->Reader.join();
+        Connections.clear();
+    }
+
+    ServerCounters PGAServer::getCounters() const {
+        ServerCounters counters;
+        counters.Connections = ConnectionCount.load();
+        counters.Requests = RequestCount.load();
+        counters.Rows = RowCount.load();
+        counters.Batches = BatchCount.load();
+        return counters;
+    }
+
+    void PGAServer::acceptConnections() {
+        while (!Stopping.load()) {
+            // Poll with a timeout so stop() is noticed without closing the socket under accept()
+            pollfd listening = {ListenSocket, POLLIN, 0};
+            int ready = poll(&listening, 1, 200);
+            reapFinishedConnections();
+            if (ready <= 0) continue;
+
+            int socket = accept(ListenSocket, nullptr, nullptr);
+            if (socket < 0) continue;
+            int on = 1;
+            setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)); // fails harmlessly on Unix sockets
+            timeval timeout = {SEND_TIMEOUT_SECONDS, 0};
+            setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+            auto connection = std::make_shared<Connection>(socket);
+            ConnectionCount.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(ConnectionsMutex);
+            connection->Reader = std::thread([this, connection] { readRequests(connection); });
+            Connections.push_back(std::move(connection));
+        }
+    }
+
+    void PGAServer::reapFinishedConnections() {
+        std::lock_guard<std::mutex> lock(ConnectionsMutex);
+        auto finished = std::stable_partition(Connections.begin(), Connections.end(),
+                                              [](const std::shared_ptr<Connection>& connection) { return !connection->Finished.load(); });
+        for (auto it = finished; it != Connections.end(); ++it) (*it)->Reader.join();
+        Connections.erase(finished, Connections.end());
+    }
+
+    // --- Reading ---
+    void PGAServer::readRequests(const std::shared_ptr<Connection>& connection) {
+        RequestHeader header;
+        while (readFully(connection->Socket, &header, sizeof(header))) {
+            if (header.Magic != PROTOCOL_MAGIC) break;
+            if (header.Rows > MAX_REQUEST_ROWS) {
+                ResponseHeader response = {PROTOCOL_MAGIC, ResponseStatus::TooLarge, header.RequestId, 0, 0};
+                std::lock_guard<std::mutex> lock(connection->WriteMutex);
+                writeFully(connection->Socket, &response, sizeof(response));
+                break;
+            }
+
+            // The rows count against QueueRows before their buffer exists, so readers waiting for
+            // capacity hold no payload memory
+            std::size_t rows = header.Rows;
+            if (!reserve(rows)) break;
+            Job job{connection, header.RequestId, std::vector<double>(3 * rows)};
+            setReceiveTimeout(connection->Socket, PAYLOAD_TIMEOUT_SECONDS);
+            bool received = readFully(connection->Socket, job.Inputs.data(), job.Inputs.size() * sizeof(double));
+            setReceiveTimeout(connection->Socket, 0);
+            if (!received) {
+                release(rows);
+                break;
+            }
+            if (!push(std::move(job))) break;
+        }
+        // Pending responses still go out; the socket closes with the last reference
+        connection->Finished.store(true);
+    }
+
+    // --- Bounded Queue ---
+    bool PGAServer::reserve(std::size_t rows) {
+        std::unique_lock<std::mutex> lock(QueueMutex);
+        // An oversized request is admitted alone so it cannot wait forever
+        NotFull.wait(lock, [&] { return QueueClosed || QueuedRows == 0 || QueuedRows + rows <= Settings.QueueRows; });
+        if (QueueClosed) return false;
+        QueuedRows += rows;
+        return true;
+    }
+
+    void PGAServer::release(std::size_t rows) {
+        {
+            std::lock_guard<std::mutex> lock(QueueMutex);
+            QueuedRows -= rows;
+        }
+        NotFull.notify_all();
+    }
+
+    bool PGAServer::push(Job&& job) {
+        {
+            std::lock_guard<std::mutex> lock(QueueMutex);
+            // The workers may already have drained the queue and exited
+            if (QueueClosed) return false;
+            Queue.push_back(std::move(job));
+        }
+        NotEmpty.notify_one();
+        return true;
+    }
+
+    bool PGAServer::popBatch(std::vector<Job>& jobs) {
+        std::size_t rows = 0;
+        {
+            std::unique_lock<std::mutex> lock(QueueMutex);
+            NotEmpty.wait(lock, [&] { return QueueClosed || !Queue.empty(); });
+            if (Queue.empty()) return false;
+            do {
+                rows += Queue.front().rows();
+                jobs.push_back(std::move(Queue.front()));
+                Queue.pop_front();
+            } while (!Queue.empty() && rows + Queue.front().rows() <= Settings.BatchRows);
+            QueuedRows -= rows;
+        }
+        NotFull.notify_all();
+        return true;
+    }
+
+    // --- Workers ---
+    void PGAServer::runWorker() {
+        std::vector<Job> jobs;
+        std::vector<double> mmax, r, f, pga;
+        std::vector<char> frame;
+
+        while (popBatch(jobs)) {
+            // De-interleave every request of the batch into one structure-of-arrays block
+            std::size_t total = 0;
+            for (const Job& job : jobs) total += job.rows();
+            mmax.resize(total);
+            r.resize(total);
+            f.resize(total);
+            pga.resize(total);
+            std::size_t row = 0;
+            for (const Job& job : jobs) {
+                for (std::size_t i = 0; i < job.rows(); ++i, ++row) {
+                    mmax[row] = job.Inputs[3 * i];
+                    r[row] = job.Inputs[3 * i + 1];
+                    f[row] = job.Inputs[3 * i + 2];
+                }
+            }
+
+            std::shared_ptr<const FDSHAEngine> engine = Engines.acquire();
+            engine->findPGABatch(mmax.data(), r.data(), f.data(), pga.data(), total);
+
+            row = 0;
+            for (const Job& job : jobs) {
+                ResponseHeader header = {PROTOCOL_MAGIC, ResponseStatus::Ok, job.RequestId, static_cast<std::uint32_t>(job.rows()), 0};
+                frame.resize(sizeof(header) + job.rows() * sizeof(double));
+                std::memcpy(frame.data(), &header, sizeof(header));
+                std::memcpy(frame.data() + sizeof(header), pga.data() + row, job.rows() * sizeof(double));
+                row += job.rows();
+                // A client that has gone away (or stopped reading) loses its responses and its connection
+                std::lock_guard<std::mutex> lock(job.Client->WriteMutex);
+                if (!writeFully(job.Client->Socket, frame.data(), frame.size())) shutdown(job.Client->Socket, SHUT_RDWR);
+            }
+
+            RequestCount.fetch_add(jobs.size(), std::memory_order_relaxed);
+            RowCount.fetch_add(total, std::memory_order_relaxed);
+            BatchCount.fetch_add(1, std::memory_order_relaxed);
+            jobs.clear();
+        }
+    }
+
+} // namespace FDSHA
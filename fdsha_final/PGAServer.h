@@ -0,0 +1,130 @@
+#ifndef PGASERVER_H
+#define PGASERVER_H
+
+#include "EngineHandle.h"
+#include "PGAProtocol.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace FDSHA {
+
+    struct ServerSettings {
+        std::string Address;              // see listenOn()
+        std::size_t Workers = 0;          // engine threads (0 = one per hardware thread)
+        std::size_t QueueRows = 1u << 20; // rows being read or waiting for a worker before readers stop reading
+        std::size_t BatchRows = 4096;     // rows a worker gathers into one findPGABatch call
+    };
+
+    // Totals since start()
+    struct ServerCounters {
+        std::uint64_t Connections = 0;
+        std::uint64_t Requests = 0;
+        std::uint64_t Rows = 0;
+        std::uint64_t Batches = 0; // findPGABatch calls (Requests / Batches = requests per batch)
+    };
+
+    /**
+     * @brief Serves PGA requests (see PGAProtocol.h) from a pool of engine workers.
+     *
+     * One reader thread per connection parses requests into a queue bounded by QueueRows.
+     * A reader reserves its request's rows in the queue after the header and before it
+     * allocates and reads the payload, so request buffers never exceed QueueRows rows in
+     * total (or one request larger than that, admitted alone). When the workers fall behind,
+     * readers block on the reservation and stop reading their sockets, so back-pressure
+     * reaches the clients through the socket buffers instead of server memory. A client that
+     * stalls mid-payload is disconnected and its reservation released. Each worker takes
+     * every queued request that fits in BatchRows (at least one), scores them in a single
+     * findPGABatch call on the EngineHandle's current engine, and writes each response as
+     * soon as its batch is done. Small concurrent requests are therefore coalesced under
+     * load without delaying any request while workers are idle.
+     */
+    class PGAServer {
+    public:
+        PGAServer(EngineHandle& engines, const ServerSettings& settings);
+        ~PGAServer();
+
+        PGAServer(const PGAServer&) = delete;
+        PGAServer& operator=(const PGAServer&) = delete;
+
+        /**
+         * @brief Binds the address and starts the acceptor and workers. Throws std::runtime_error
+         *        if the address cannot be bound.
+         */
+        void start();
+
+        /**
+         * @brief Stops accepting, closes every connection and joins all threads. Requests that
+         *        were already queued are still answered if their client is listening.
+         */
+        void stop();
+
+        ServerCounters getCounters() const;
+
+    private:
+        struct Connection {
+            int Socket;
+            std::mutex WriteMutex;          // one response frame at a time
+            std::atomic<bool> Finished{false};
+            std::thread Reader;
+
+            explicit Connection(int socket) : Socket(socket) {}
+            ~Connection();
+        };
+
+        // One parsed request: interleaved (Mmax, R, F) rows
+        struct Job {
+            std::shared_ptr<Connection> Client;
+            std::uint64_t RequestId;
+            std::vector<double> Inputs;
+
+            std::size_t rows() const { return Inputs.size() / 3; }
+        };
+
+        EngineHandle& Engines;
+        ServerSettings Settings;
+        int ListenSocket = -1;
+        std::atomic<bool> Stopping{false};
+
+        std::thread Acceptor;
+        std::vector<std::thread> Workers;
+
+        std::mutex ConnectionsMutex;
+        std::vector<std::shared_ptr<Connection>> Connections;
+
+        // Bounded request queue
+        std::mutex QueueMutex;
+        std::condition_variable NotEmpty;
+        std::condition_variable NotFull;
+        std::deque<Job> Queue;
+        std::size_t QueuedRows = 0;     // reserved by readers or queued
+        bool QueueClosed = false;
+
+        std::atomic<std::uint64_t> ConnectionCount{0};
+        std::atomic<std::uint64_t> RequestCount{0};
+        std::atomic<std::uint64_t> RowCount{0};
+        std::atomic<std::uint64_t> BatchCount{0};
+
+        void acceptConnections();
+        void readRequests(const std::shared_ptr<Connection>& connection);
+        void runWorker();
+
+        // reserve() waits for room for rows; the rows are then either released after a failed
+        // read or pushed as a job. Both reserve() and push() return false once the queue is closed.
+        bool reserve(std::size_t rows);
+        void release(std::size_t rows);
+        bool push(Job&& job);
+        bool popBatch(std::vector<Job>& jobs);
+        void reapFinishedConnections();
+    };
+
+} // namespace FDSHA
+
+#endif // PGASERVER_H
@@ -0,0 +1,57 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <array>
+#include <cstdint>
+
+namespace FDSHA {
+
+    /**
+     * @brief Philox4x32-10 counter-based generator (Salmon et al., SC'11).
+     *
+     * Maps a 128-bit counter and a 64-bit key to 128 random bits with no state in between,
+     * so draw i of stream k is the same no matter which thread computes it or in what order.
+     */
+    class Philox4x32 {
+    public:
+        using Block = std::array<std::uint32_t, 4>;
+
+        explicit Philox4x32(std::uint64_t key)
+            : Key{static_cast<std::uint32_t>(key), static_cast<std::uint32_t>(key >> 32)} {}
+
+        Block operator()(std::uint64_t counterLow, std::uint64_t counterHigh) const {
+            Block x = {static_cast<std::uint32_t>(counterLow), static_cast<std::uint32_t>(counterLow >> 32),
+                       static_cast<std::uint32_t>(counterHigh), static_cast<std::uint32_t>(counterHigh >> 32)};
+            std::uint32_t k0 = Key[0];
+            std::uint32_t k1 = Key[1];
+            for (int round = 0; round < 10; ++round) {
+                std::uint64_t p0 = static_cast<std::uint64_t>(MULTIPLIER_0) * x[0];
+                std::uint64_t p1 = static_cast<std::uint64_t>(MULTIPLIER_1) * x[2];
+                x = {static_cast<std::uint32_t>(p1 >> 32) ^ x[1] ^ k0, static_cast<std::uint32_t>(p1),
+                     static_cast<std::uint32_t>(p0 >> 32) ^ x[3] ^ k1, static_cast<std::uint32_t>(p0)};
+                k0 += WEYL_0;
+                k1 += WEYL_1;
+            }
+            return x;
+        }
+
+        /**
+         * @brief Uniform double in the open interval (0, 1) from two 32-bit words (53 random bits).
+         */
+        static double toUnitInterval(std::uint32_t high, std::uint32_t low) {
+            std::uint64_t bits = ((static_cast<std::uint64_t>(high) << 32) | low) >> 11;
+            return (static_cast<double>(bits) + 0.5) * 0x1.0p-53;
+        }
+
+    private:
+        static constexpr std::uint32_t MULTIPLIER_0 = 0xD2511F53;
+        static constexpr std::uint32_t MULTIPLIER_1 = 0xCD9E8D57;
+        static constexpr std::uint32_t WEYL_0 = 0x9E3779B9;
+        static constexpr std::uint32_t WEYL_1 = 0xBB67AE85;
+
+        std::array<std::uint32_t, 2> Key;
+    };
+
+} // namespace FDSHA
+
+#endif // PHILOX_H
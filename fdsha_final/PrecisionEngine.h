@@ -0,0 +1,302 @@
+#ifndef PRECISIONENGINE_H
+#define PRECISIONENGINE_H
+
+#include "FDSHAEngine.h"
+#include "FixedPoint.h"
+#include "FuzzyModel.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace FDSHA {
+
+    /**
+     * @brief Mamdani inference (Max-Min, sampled COG) carried out in Scalar arithmetic.
+     *
+     * Runs a model the way FDSHAEngine's reference path does, with float, Fixed32 (or double)
+     * in place of double for the sets, the COG sample table and every intermediate; inputs and
+     * outputs stay double. PrecisionEngine<float> runs findPGABatch on the single-precision
+     * SIMD kernels (twice the lanes of the double ones) and halves the sample table; other
+     * Scalars use portable lane loops. measurePrecision() reports the deviation from the double
+     * engine, to pick the cheapest Scalar a tolerance allows.
+     */
+    template <typename Scalar>
+    class PrecisionEngine {
+    private:
+        // MembershipFunction with Scalar breakpoints
+        struct ScalarSet {
+            Scalar a, b, c, d;
+
+            Scalar getMembershipDegree(Scalar x) const {
+                if (x <= a || x >= d) return Scalar(0.0);
+                // Peak (membership = 1.0)
+                if (x >= b && x <= c) return Scalar(1.0);
+                // Rising slope
+                if (x < b) return (x - a) / (b - a);
+                // Falling slope
+                return (d - x) / (d - c);
+            }
+        };
+
+        template <std::size_t TermCount>
+        static std::array<ScalarSet, TermCount> convert(const std::array<MembershipFunction, TermCount>& sets) {
+            std::array<ScalarSet, TermCount> converted;
+            for (std::size_t i = 0; i < TermCount; ++i) {
+                converted[i] = {Scalar(sets[i].a), Scalar(sets[i].b), Scalar(sets[i].c), Scalar(sets[i].d)};
+            }
+            return converted;
+        }
+
+        std::array<ScalarSet, MAGNITUDE_TERM_COUNT> MmaxSets;
+        std::array<ScalarSet, DISTANCE_TERM_COUNT> RSets;
+        std::array<ScalarSet, FAULT_TYPE_TERM_COUNT> FSets;
+        RuleCube Rules;
+
+        // The model's sets, which the float kernels convert lane-wise
+        std::array<MembershipFunction, MAGNITUDE_TERM_COUNT> MmaxFunctions;
+        std::array<MembershipFunction, DISTANCE_TERM_COUNT> RFunctions;
+        std::array<MembershipFunction, FAULT_TYPE_TERM_COUNT> FFunctions;
+        std::uint64_t ModelFingerprint;
+
+        // Sampled COG: sample abscissae and the PGA set degrees at each of them (term-minor)
+        int SampleCount;
+        double PGAMin;
+        double StepSize;
+        std::vector<Scalar> SamplePoints;
+        std::vector<Scalar> SampleMemberships;
+        Scalar Fallback;
+
+        // Instruction set of the float kernels
+        SimdLevel BatchSimdLevel = detectSimdLevel();
+
+        // One block of at most 64 lanes on the single-precision kernels
+        void findPGABlockFloat(const double* mmaxInputs, const double* rInputs, const double* fInputs,
+                               double* pgaOutputs, std::size_t n) const {
+            constexpr std::size_t BLOCK_SIZE = 64;
+            std::array<float, BLOCK_SIZE> mmax, r, f, pga;
+            std::array<float, MAGNITUDE_TERM_COUNT * BLOCK_SIZE> mmaxMemberships;
+            std::array<float, DISTANCE_TERM_COUNT * BLOCK_SIZE> rMemberships;
+            std::array<float, FAULT_TYPE_TERM_COUNT * BLOCK_SIZE> fMemberships;
+            std::array<float, PGA_TERM_COUNT * BLOCK_SIZE> aggregatedConsequents;
+            const FloatBatchKernels& kernels = getFloatBatchKernels(BatchSimdLevel);
+
+            for (std::size_t lane = 0; lane < n; ++lane) {
+                mmax[lane] = static_cast<float>(mmaxInputs[lane]);
+                r[lane] = static_cast<float>(rInputs[lane]);
+                f[lane] = static_cast<float>(fInputs[lane]);
+            }
+            for (std::size_t i = 0; i < MAGNITUDE_TERM_COUNT; ++i) kernels.fuzzify(MmaxFunctions[i], mmax.data(), &mmaxMemberships[i * n], n);
+            for (std::size_t i = 0; i < DISTANCE_TERM_COUNT; ++i) kernels.fuzzify(RFunctions[i], r.data(), &rMemberships[i * n], n);
+            for (std::size_t i = 0; i < FAULT_TYPE_TERM_COUNT; ++i) kernels.fuzzify(FFunctions[i], f.data(), &fMemberships[i * n], n);
+            kernels.infer(mmaxMemberships.data(), rMemberships.data(), fMemberships.data(), Rules.data(),
+                          aggregatedConsequents.data(), n);
+            kernels.defuzzifySampled(aggregatedConsequents.data(), SampleMemberships.data(), SampleCount, static_cast<float>(PGAMin),
+                                     static_cast<float>(StepSize), Fallback, pga.data(), n);
+            for (std::size_t lane = 0; lane < n; ++lane) pgaOutputs[lane] = pga[lane];
+        }
+
+    public:
+        /**
+         * @brief Builds the engine from a model; sampleCount matches FDSHAEngine::setSampleCount.
+         *        Throws std::invalid_argument if the model fails FuzzyModel::validate().
+         */
+        explicit PrecisionEngine(const FuzzyModel& model, int sampleCount = 1000)
+            : MmaxSets(convert(model.MmaxSets)), RSets(convert(model.RSets)), FSets(convert(model.FSets)),
+              Rules(model.compileRules()), MmaxFunctions(model.MmaxSets), RFunctions(model.RSets), FFunctions(model.FSets),
+              ModelFingerprint(model.fingerprint()), SampleCount(sampleCount) {
+            model.validate();
+            if (sampleCount < 1) throw std::invalid_argument("PrecisionEngine: sample count must be positive");
+
+            // Abscissae and degrees are computed in double, exactly as FDSHAEngine does, then rounded once
+            PGAMin = model.PGAUniverse.Min;
+            StepSize = (model.PGAUniverse.Max - PGAMin) / sampleCount;
+            SamplePoints.reserve(static_cast<std::size_t>(sampleCount) + 1);
+            SampleMemberships.reserve((static_cast<std::size_t>(sampleCount) + 1) * PGA_TERM_COUNT);
+            for (int i = 0; i <= sampleCount; ++i) {
+                double x = PGAMin + i * StepSize;
+                SamplePoints.push_back(Scalar(x));
+                for (const MembershipFunction& set : model.PGASets) SampleMemberships.push_back(Scalar(set.getMembershipDegree(x)));
+            }
+            Fallback = Scalar((model.PGAUniverse.Min + model.PGAUniverse.Max) / 2.0);
+        }
+
+        std::uint64_t getModelFingerprint() const { return ModelFingerprint; }
+        int getSampleCount() const { return SampleCount; }
+
+        /**
+         * @brief Selects the float kernels (clamped to what the CPU supports; best available by default).
+         */
+        void setSimdLevel(SimdLevel level) { BatchSimdLevel = std::min(level, detectSimdLevel()); }
+        SimdLevel getSimdLevel() const { return BatchSimdLevel; }
+
+        /**
+         * @brief Bytes held by the COG sample tables.
+         */
+        std::size_t getTableBytes() const { return (SamplePoints.size() + SampleMemberships.size()) * sizeof(Scalar); }
+
+        double findPGA(double mmaxInput, double rInput, double fInput) const {
+            double pga;
+            findPGABatch(&mmaxInput, &rInput, &fInput, &pga, 1);
+            return pga;
+        }
+
+        /**
+         * @brief findPGA over structure-of-arrays inputs, in blocks of lanes.
+         */
+        void findPGABatch(const double* mmaxInputs, const double* rInputs, const double* fInputs,
+                          double* pgaOutputs, std::size_t count) const {
+            constexpr std::size_t BLOCK_SIZE = 64;
+            std::array<Scalar, MAGNITUDE_TERM_COUNT * BLOCK_SIZE> mmaxMemberships;
+            std::array<Scalar, DISTANCE_TERM_COUNT * BLOCK_SIZE> rMemberships;
+            std::array<Scalar, FAULT_TYPE_TERM_COUNT * BLOCK_SIZE> fMemberships;
+            std::array<Scalar, PGA_TERM_COUNT * BLOCK_SIZE> aggregatedConsequents;
+            std::array<Scalar, BLOCK_SIZE> numerators;
+            std::array<Scalar, BLOCK_SIZE> denominators;
+
+            for (std::size_t start = 0; start < count; start += BLOCK_SIZE) {
+                std::size_t n = std::min(BLOCK_SIZE, count - start);
+                if constexpr (std::is_same<Scalar, float>::value) {
+                    findPGABlockFloat(mmaxInputs + start, rInputs + start, fInputs + start, pgaOutputs + start, n);
+                    continue;
+                }
+
+                // 1. FUZZIFICATION
+                for (std::size_t lane = 0; lane < n; ++lane) {
+                    Scalar mmax(mmaxInputs[start + lane]);
+                    Scalar r(rInputs[start + lane]);
+                    Scalar f(fInputs[start + lane]);
+                    for (std::size_t i = 0; i < MAGNITUDE_TERM_COUNT; ++i) mmaxMemberships[i * n + lane] = MmaxSets[i].getMembershipDegree(mmax);
+                    for (std::size_t i = 0; i < DISTANCE_TERM_COUNT; ++i) rMemberships[i * n + lane] = RSets[i].getMembershipDegree(r);
+                    for (std::size_t i = 0; i < FAULT_TYPE_TERM_COUNT; ++i) fMemberships[i * n + lane] = FSets[i].getMembershipDegree(f);
+                }
+
+                // 2. INFERENCE & AGGREGATION (Max-Min)
+                std::fill(aggregatedConsequents.begin(), aggregatedConsequents.begin() + PGA_TERM_COUNT * n, Scalar(0.0));
+                for (std::size_t m = 0; m < MAGNITUDE_TERM_COUNT; ++m) {
+                    for (std::size_t r = 0; r < DISTANCE_TERM_COUNT; ++r) {
+                        for (std::size_t f = 0; f < FAULT_TYPE_TERM_COUNT; ++f) {
+                            Scalar* alphas = &aggregatedConsequents[toIndex(Rules[ruleIndex(m, r, f)]) * n];
+                            for (std::size_t lane = 0; lane < n; ++lane) {
+                                Scalar alpha = std::min(std::min(mmaxMemberships[m * n + lane], rMemberships[r * n + lane]),
+                                                        fMemberships[f * n + lane]);
+                                alphas[lane] = std::max(alphas[lane], alpha);
+                            }
+                        }
+                    }
+                }
+
+                // 3. DEFUZZIFICATION (sampled COG) over the consequents that fired in some lane
+                std::array<std::size_t, PGA_TERM_COUNT> activeTerms;
+                std::size_t activeCount = 0;
+                for (std::size_t term = 0; term < PGA_TERM_COUNT; ++term) {
+                    const Scalar* alphas = &aggregatedConsequents[term * n];
+                    if (std::any_of(alphas, alphas + n, [](Scalar alpha) { return alpha > Scalar(0.0); })) activeTerms[activeCount++] = term;
+                }
+                std::fill(numerators.begin(), numerators.begin() + n, Scalar(0.0));
+                std::fill(denominators.begin(), denominators.begin() + n, Scalar(0.0));
+                for (std::size_t i = 0; activeCount > 0 && i < SamplePoints.size(); ++i) {
+                    const Scalar* baseMemberships = &SampleMemberships[i * PGA_TERM_COUNT];
+                    Scalar x = SamplePoints[i];
+                    std::array<Scalar, BLOCK_SIZE> aggregatedMemberships;
+                    std::fill(aggregatedMemberships.begin(), aggregatedMemberships.begin() + n, Scalar(0.0));
+                    for (std::size_t k = 0; k < activeCount; ++k) {
+                        // Clipping (Min) and aggregation (Max)
+                        Scalar baseMembership = baseMemberships[activeTerms[k]];
+                        const Scalar* alphas = &aggregatedConsequents[activeTerms[k] * n];
+                        for (std::size_t lane = 0; lane < n; ++lane) {
+                            aggregatedMemberships[lane] = std::max(aggregatedMemberships[lane], std::min(baseMembership, alphas[lane]));
+                        }
+                    }
+                    for (std::size_t lane = 0; lane < n; ++lane) {
+                        numerators[lane] += x * aggregatedMemberships[lane];
+                        denominators[lane] += aggregatedMemberships[lane];
+                    }
+                }
+                for (std::size_t lane = 0; lane < n; ++lane) {
+                    Scalar pga = denominators[lane] == Scalar(0.0) ? Fallback : numerators[lane] / denominators[lane];
+                    pgaOutputs[start + lane] = static_cast<double>(pga);
+                }
+            }
+        }
+    };
+
+    // Deviation of a PrecisionEngine from the double reference over a grid of the input domain
+    struct PrecisionReport {
+        std::size_t Points = 0;
+        double MaxDeviation = 0.0;  // max |PGA - reference PGA| (g)
+        double MeanDeviation = 0.0;
+        double WorstMmax = 0.0;     // input at which MaxDeviation occurs
+        double WorstR = 0.0;
+        double WorstF = 0.0;
+        std::size_t TableBytes = 0; // PrecisionEngine::getTableBytes()
+    };
+
+    /**
+     * @brief Compares engine with reference on pointsPerAxis evenly spaced values of each input
+     *        universe (pointsPerAxis^3 points, universe ends included).
+     *
+     * The reference must run the same model with the sampled COG and the same sample count;
+     * otherwise std::invalid_argument is thrown.
+     */
+    template <typename Scalar>
+    PrecisionReport measurePrecision(const FDSHAEngine& reference, const PrecisionEngine<Scalar>& engine,
+                                     std::size_t pointsPerAxis = 64) {
+        if (reference.getModelFingerprint() != engine.getModelFingerprint()
+            || reference.getDefuzzificationMethod() != DefuzzificationMethod::SampledCenterOfGravity
+            || reference.getSampleCount() != engine.getSampleCount()) {
+            throw std::invalid_argument("measurePrecision: reference must run the same model with the same sampled COG");
+        }
+        if (pointsPerAxis < 2) throw std::invalid_argument("measurePrecision: need at least 2 points per axis");
+
+        auto axis = [pointsPerAxis](Universe universe) {
+            std::vector<double> values(pointsPerAxis);
+            for (std::size_t i = 0; i < pointsPerAxis; ++i) {
+                values[i] = universe.Min + (universe.Max - universe.Min) * static_cast<double>(i) / static_cast<double>(pointsPerAxis - 1);
+            }
+            return values;
+        };
+        const std::vector<double> mmaxValues = axis(reference.getMagnitudeUniverse());
+        const std::vector<double> rValues = axis(reference.getDistanceUniverse());
+        const std::vector<double> fValues = axis(reference.getFaultTypeUniverse());
+
+        // One Mmax plane per batch call
+        const std::size_t PLANE = pointsPerAxis * pointsPerAxis;
+        std::vector<double> mmax(PLANE), r(PLANE), f(PLANE), expected(PLANE), actual(PLANE);
+        for (std::size_t j = 0; j < pointsPerAxis; ++j) {
+            for (std::size_t k = 0; k < pointsPerAxis; ++k) {
+                r[j * pointsPerAxis + k] = rValues[j];
+                f[j * pointsPerAxis + k] = fValues[k];
+            }
+        }
+
+        PrecisionReport report;
+        report.TableBytes = engine.getTableBytes();
+        double total = 0.0;
+        for (double m : mmaxValues) {
+            std::fill(mmax.begin(), mmax.end(), m);
+            reference.findPGABatch(mmax.data(), r.data(), f.data(), expected.data(), PLANE);
+            engine.findPGABatch(mmax.data(), r.data(), f.data(), actual.data(), PLANE);
+            for (std::size_t i = 0; i < PLANE; ++i) {
+                double deviation = std::fabs(actual[i] - expected[i]);
+                total += deviation;
+                if (deviation > report.MaxDeviation || report.Points == 0) {
+                    report.MaxDeviation = deviation;
+                    report.WorstMmax = m;
+                    report.WorstR = r[i];
+                    report.WorstF = f[i];
+                }
+                ++report.Points;
+            }
+        }
+        report.MeanDeviation = total / static_cast<double>(report.Points);
+        return report;
+    }
+
+} // namespace FDSHA
+
+#endif // PRECISIONENGINE_H
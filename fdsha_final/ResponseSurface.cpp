@@ -0,0 +1,234 @@
+#include "ResponseSurface.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace FDSHA {
+
+    namespace {
+
+        const char SURFACE_MAGIC[8] = {'F', 'D', 'S', 'H', 'A', 'R', 'S', '2'};
+        const std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+        // On-disk header; the values follow immediately after it
+        struct SurfaceFileHeader {
+            char Magic[8];
+            std::uint32_t ByteOrder;
+            std::uint32_t HeaderSize;
+            double AxisMin[3];
+            double AxisMax[3];
+            std::uint64_t AxisPoints[3];
+            std::uint64_t ModelFingerprint;
+            std::uint32_t Defuzzification;
+            std::uint32_t SampleCount;
+            std::uint8_t Reserved[24];
+        };
+        static_assert(sizeof(SurfaceFileHeader) == 128, "surface header must stay 128 bytes");
+
+        bool isValidAxis(const GridAxis& axis) {
+            return axis.Points >= 2 && axis.Max > axis.Min && std::isfinite(axis.Max - axis.Min);
+        }
+
+        void validateAxis(const GridAxis& axis, const char* name) {
+            if (!isValidAxis(axis)) throw std::invalid_argument(std::string("ResponseSurface: invalid ") + name + " axis");
+        }
+
+        // Cell index and fractional position of x along an axis, clamped to the grid
+        double locateCell(const GridAxis& axis, double x, std::size_t& cell) {
+            double t = (x - axis.Min) / axis.step();
+            if (!(t > 0.0)) { cell = 0; return 0.0; }
+            if (t >= static_cast<double>(axis.Points - 1)) { cell = axis.Points - 2; return 1.0; }
+            cell = static_cast<std::size_t>(t);
+            return t - static_cast<double>(cell);
+        }
+
+        // Node coordinate used when tabulating. The end nodes are sampled just inside the box:
+        // the sets vanish exactly on their outer breakpoints (e.g. Near at R = 0), and that single
+        // degenerate point would otherwise smear across the whole first and last cells.
+        double nodeAt(const GridAxis& axis, std::size_t i) {
+            if (i == 0) return std::nextafter(axis.Min, axis.Max);
+            if (i == axis.Points - 1) return std::nextafter(axis.Max, axis.Min);
+            return axis.at(i);
+        }
+
+    } // namespace
+
+    // --- Provenance ---
+    SurfaceProvenance SurfaceProvenance::of(const FDSHAEngine& engine) {
+        SurfaceProvenance provenance;
+        provenance.ModelFingerprint = engine.getModelFingerprint();
+        provenance.Defuzzification = static_cast<std::uint32_t>(engine.getDefuzzificationMethod());
+        provenance.SampleCount = static_cast<std::uint32_t>(engine.getSampleCount());
+        return provenance;
+    }
+
+    bool SurfaceProvenance::operator==(const SurfaceProvenance& other) const {
+        return ModelFingerprint == other.ModelFingerprint && Defuzzification == other.Defuzzification
+            && SampleCount == other.SampleCount;
+    }
+
+    // --- Construction ---
+    ResponseSurface ResponseSurface::build(const FDSHAEngine& engine, const GridAxis& mmaxAxis, const GridAxis& rAxis, const GridAxis& fAxis) {
+        validateAxis(mmaxAxis, "Mmax");
+        validateAxis(rAxis, "R");
+        validateAxis(fAxis, "F");
+
+        auto table = std::make_shared<std::vector<double>>(mmaxAxis.Points * rAxis.Points * fAxis.Points);
+        std::vector<double> mmaxRow(fAxis.Points), rRow(fAxis.Points), fRow(fAxis.Points);
+        for (std::size_t f = 0; f < fAxis.Points; ++f) fRow[f] = nodeAt(fAxis, f);
+
+        // One batch call per (Mmax, R) row of F values
+        for (std::size_t m = 0; m < mmaxAxis.Points; ++m) {
+            std::fill(mmaxRow.begin(), mmaxRow.end(), nodeAt(mmaxAxis, m));
+            for (std::size_t r = 0; r < rAxis.Points; ++r) {
+                std::fill(rRow.begin(), rRow.end(), nodeAt(rAxis, r));
+                double* out = table->data() + (m * rAxis.Points + r) * fAxis.Points;
+                engine.findPGABatch(mmaxRow.data(), rRow.data(), fRow.data(), out, fAxis.Points);
+            }
+        }
+
+        ResponseSurface surface;
+        surface.MmaxAxis = mmaxAxis;
+        surface.RAxis = rAxis;
+        surface.FAxis = fAxis;
+        surface.Provenance = SurfaceProvenance::of(engine);
+        surface.Values = table->data();
+        surface.Storage = std::move(table);
+        return surface;
+    }
+
+    ResponseSurface ResponseSurface::build(const FDSHAEngine& engine, std::size_t mmaxPoints, std::size_t rPoints, std::size_t fPoints) {
+        Universe mmax = engine.getMagnitudeUniverse();
+        Universe r = engine.getDistanceUniverse();
+        Universe f = engine.getFaultTypeUniverse();
+        return build(engine, {mmax.Min, mmax.Max, mmaxPoints}, {r.Min, r.Max, rPoints}, {f.Min, f.Max, fPoints});
+    }
+
+    // --- Persistence ---
+    void ResponseSurface::save(const std::string& path) const {
+        if (empty()) throw std::logic_error("ResponseSurface: nothing to save");
+
+        SurfaceFileHeader header{};
+        std::memcpy(header.Magic, SURFACE_MAGIC, sizeof(SURFACE_MAGIC));
+        header.ByteOrder = BYTE_ORDER_MARK;
+        header.HeaderSize = sizeof(SurfaceFileHeader);
+        const GridAxis* axes[3] = {&MmaxAxis, &RAxis, &FAxis};
+        for (int i = 0; i < 3; ++i) {
+            header.AxisMin[i] = axes[i]->Min;
+            header.AxisMax[i] = axes[i]->Max;
+            header.AxisPoints[i] = axes[i]->Points;
+        }
+        header.ModelFingerprint = Provenance.ModelFingerprint;
+        header.Defuzzification = Provenance.Defuzzification;
+        header.SampleCount = Provenance.SampleCount;
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(Values),
+                  static_cast<std::streamsize>(MmaxAxis.Points * RAxis.Points * FAxis.Points * sizeof(double)));
+        if (!out) throw std::runtime_error("ResponseSurface: cannot write " + path);
+    }
+
+    ResponseSurface ResponseSurface::load(const std::string& path, const FDSHAEngine& engine) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("ResponseSurface: cannot open " + path);
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(SurfaceFileHeader)) {
+            ::close(fd);
+            throw std::runtime_error("ResponseSurface: " + path + " is not a surface file");
+        }
+        std::size_t length = static_cast<std::size_t>(info.st_size);
+        void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) throw std::runtime_error("ResponseSurface: cannot map " + path);
+        std::shared_ptr<const void> storage(mapping, [length](const void* p) { ::munmap(const_cast<void*>(p), length); });
+
+        const auto* header = static_cast<const SurfaceFileHeader*>(mapping);
+        if (std::memcmp(header->Magic, SURFACE_MAGIC, sizeof(SURFACE_MAGIC)) != 0 || header->ByteOrder != BYTE_ORDER_MARK
+            || header->HeaderSize != sizeof(SurfaceFileHeader)) {
+            throw std::runtime_error("ResponseSurface: " + path + " is not a surface file for this platform");
+        }
+
+        ResponseSurface surface;
+        GridAxis* axes[3] = {&surface.MmaxAxis, &surface.RAxis, &surface.FAxis};
+        for (int i = 0; i < 3; ++i) {
+            *axes[i] = {header->AxisMin[i], header->AxisMax[i], static_cast<std::size_t>(header->AxisPoints[i])};
+        }
+        if (!isValidAxis(surface.MmaxAxis) || !isValidAxis(surface.RAxis) || !isValidAxis(surface.FAxis)) {
+            throw std::runtime_error("ResponseSurface: " + path + " has an invalid grid");
+        }
+        surface.Provenance.ModelFingerprint = header->ModelFingerprint;
+        surface.Provenance.Defuzzification = header->Defuzzification;
+        surface.Provenance.SampleCount = header->SampleCount;
+        if (surface.Provenance != SurfaceProvenance::of(engine)) {
+            throw std::runtime_error("ResponseSurface: " + path + " was built from a different model, defuzzifier or sample count");
+        }
+        // Checked against the file size one axis at a time so a corrupt count cannot overflow
+        std::size_t capacity = (length - sizeof(SurfaceFileHeader)) / sizeof(double);
+        std::size_t planes = surface.MmaxAxis.Points * surface.RAxis.Points;
+        if (surface.MmaxAxis.Points > capacity || surface.RAxis.Points > capacity / surface.MmaxAxis.Points
+            || surface.FAxis.Points > capacity / planes
+            || length != sizeof(SurfaceFileHeader) + planes * surface.FAxis.Points * sizeof(double)) {
+            throw std::runtime_error("ResponseSurface: " + path + " is truncated");
+        }
+
+        surface.Values = reinterpret_cast<const double*>(static_cast<const char*>(mapping) + sizeof(SurfaceFileHeader));
+        surface.Storage = std::move(storage);
+        return surface;
+    }
+
+    // --- Queries ---
+    double ResponseSurface::findPGA(double mmaxInput, double rInput, double fInput) const {
+        std::size_t m, r, f;
+        double tm = locateCell(MmaxAxis, mmaxInput, m);
+        double tr = locateCell(RAxis, rInput, r);
+        double tf = locateCell(FAxis, fInput, f);
+
+        // Interpolate along F, then R, then Mmax
+        auto lerp = [](double lo, double hi, double t) { return lo + (hi - lo) * t; };
+        double c00 = lerp(value(m, r, f), value(m, r, f + 1), tf);
+        double c01 = lerp(value(m, r + 1, f), value(m, r + 1, f + 1), tf);
+        double c10 = lerp(value(m + 1, r, f), value(m + 1, r, f + 1), tf);
+        double c11 = lerp(value(m + 1, r + 1, f), value(m + 1, r + 1, f + 1), tf);
+        return lerp(lerp(c00, c01, tr), lerp(c10, c11, tr), tm);
+    }
+
+    SurfaceErrorReport ResponseSurface::measureError(const FDSHAEngine& engine, std::size_t probesPerAxis) const {
+        if (empty() || probesPerAxis == 0) return {0.0, 0.0, 0};
+
+        auto probe = [probesPerAxis](const GridAxis& axis, std::size_t i) {
+            return axis.Min + (static_cast<double>(i) + 0.5) * (axis.Max - axis.Min) / static_cast<double>(probesPerAxis);
+        };
+
+        std::vector<double> mmaxRow(probesPerAxis), rRow(probesPerAxis), fRow(probesPerAxis), exact(probesPerAxis);
+        for (std::size_t f = 0; f < probesPerAxis; ++f) fRow[f] = probe(FAxis, f);
+
+        double maxError = 0.0;
+        double sumError = 0.0;
+        for (std::size_t m = 0; m < probesPerAxis; ++m) {
+            std::fill(mmaxRow.begin(), mmaxRow.end(), probe(MmaxAxis, m));
+            for (std::size_t r = 0; r < probesPerAxis; ++r) {
+                std::fill(rRow.begin(), rRow.end(), probe(RAxis, r));
+                engine.findPGABatch(mmaxRow.data(), rRow.data(), fRow.data(), exact.data(), probesPerAxis);
+                for (std::size_t f = 0; f < probesPerAxis; ++f) {
+                    double error = std::fabs(findPGA(mmaxRow[f], rRow[f], fRow[f]) - exact[f]);
+                    maxError = std::max(maxError, error);
+                    sumError += error;
+                }
+            }
+        }
+        std::size_t samples = probesPerAxis * probesPerAxis * probesPerAxis;
+        return {maxError, sumError / static_cast<double>(samples), samples};
+    }
+
+} // namespace FDSHA
@@ -0,0 +1,109 @@
+#ifndef RESPONSESURFACE_H
+#define RESPONSESURFACE_H
+
+#include "FDSHAEngine.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace FDSHA {
+
+    // Evenly spaced grid points along one input axis
+    struct GridAxis {
+        double Min;
+        double Max;
+        std::size_t Points;
+
+        double step() const { return (Max - Min) / static_cast<double>(Points - 1); }
+        double at(std::size_t i) const { return Min + static_cast<double>(i) * step(); }
+    };
+
+    // Engine configuration a surface was tabulated from; load() only accepts a matching engine
+    struct SurfaceProvenance {
+        std::uint64_t ModelFingerprint = 0;   // FuzzyModel::fingerprint()
+        std::uint32_t Defuzzification = 0;    // DefuzzificationMethod
+        std::uint32_t SampleCount = 0;
+
+        static SurfaceProvenance of(const FDSHAEngine& engine);
+        bool operator==(const SurfaceProvenance& other) const;
+        bool operator!=(const SurfaceProvenance& other) const { return !(*this == other); }
+    };
+
+    // Interpolation error of a surface measured against the exact engine
+    struct SurfaceErrorReport {
+        double MaxAbsError;
+        double MeanAbsError;
+        std::size_t Samples;
+    };
+
+    /**
+     * @brief Tabulated PGA response surface over (Mmax, R, F) served by trilinear interpolation.
+     *
+     * A drop-in fast path for findPGA: the table is filled once from an engine (or mapped from a
+     * file written by save()) and queries cost a handful of loads. Inputs outside the tabulated box
+     * are clamped to its faces. The file layout is a fixed 128-byte header (axes and provenance)
+     * followed by the values as native doubles (F fastest, then R, then Mmax), so load() maps it
+     * without copying.
+     */
+    class ResponseSurface {
+    private:
+        GridAxis MmaxAxis{};
+        GridAxis RAxis{};
+        GridAxis FAxis{};
+        SurfaceProvenance Provenance;
+
+        // Keeps the owning buffer or file mapping alive; Values points into it
+        std::shared_ptr<const void> Storage;
+        const double* Values = nullptr;
+
+        double value(std::size_t m, std::size_t r, std::size_t f) const {
+            return Values[(m * RAxis.Points + r) * FAxis.Points + f];
+        }
+
+    public:
+        ResponseSurface() = default;
+
+        /**
+         * @brief Tabulates engine.findPGA on the given grid.
+         */
+        static ResponseSurface build(const FDSHAEngine& engine, const GridAxis& mmaxAxis, const GridAxis& rAxis, const GridAxis& fAxis);
+
+        /**
+         * @brief Tabulates engine.findPGA over the engine's own input universes.
+         */
+        static ResponseSurface build(const FDSHAEngine& engine, std::size_t mmaxPoints, std::size_t rPoints, std::size_t fPoints);
+
+        /**
+         * @brief Memory-maps a surface written by save(). Throws std::runtime_error on a bad file
+         *        or one tabulated from a different model, defuzzifier or sample count than engine.
+         */
+        static ResponseSurface load(const std::string& path, const FDSHAEngine& engine);
+
+        /**
+         * @brief Writes the surface in the memory-mappable binary format.
+         */
+        void save(const std::string& path) const;
+
+        /**
+         * @brief Trilinear interpolation of the tabulated PGA.
+         */
+        double findPGA(double mmaxInput, double rInput, double fInput) const;
+
+        /**
+         * @brief Compares the surface with the engine at the centres of a probesPerAxis^3 grid of
+         *        cells over the table's box. With probesPerAxis == Points - 1 on an axis, the probes
+         *        fall midway between table nodes, the worst case for interpolation.
+         */
+        SurfaceErrorReport measureError(const FDSHAEngine& engine, std::size_t probesPerAxis) const;
+
+        const GridAxis& getMagnitudeAxis() const { return MmaxAxis; }
+        const GridAxis& getDistanceAxis() const { return RAxis; }
+        const GridAxis& getFaultTypeAxis() const { return FAxis; }
+        const SurfaceProvenance& getProvenance() const { return Provenance; }
+        bool empty() const { return Values == nullptr; }
+    };
+
+} // namespace FDSHA
+
+#endif // RESPONSESURFACE_H
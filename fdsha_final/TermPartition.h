@@ -0,0 +1,75 @@
+#ifndef TERMPARTITION_H
+#define TERMPARTITION_H
+
+#include "FuzzySet.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace FDSHA {
+
+    /**
+     * @brief Terms whose membership can be non-zero somewhere inside one partition interval.
+     */
+    template <std::size_t TermCount>
+    struct ActiveTerms {
+        std::array<std::size_t, TermCount> Terms{};
+        std::size_t Count = 0;
+    };
+
+    /**
+     * @brief Splits an input axis at every set breakpoint and records which terms are active
+     *        in each interval, so fuzzification only touches those terms.
+     *
+     * A set is non-zero only on its open support (a, d). Interval i is [Breakpoints[i], Breakpoints[i + 1]);
+     * a crisp value on a breakpoint belongs to the interval on its right, which holds every set
+     * whose support contains it.
+     */
+    template <std::size_t TermCount>
+    class TermPartition {
+    private:
+        std::vector<double> Breakpoints;
+        std::vector<ActiveTerms<TermCount>> Intervals;
+        ActiveTerms<TermCount> None;
+
+    public:
+        void build(const std::array<MembershipFunction, TermCount>& sets) {
+            Breakpoints.clear();
+            for (const auto& set : sets) {
+                Breakpoints.insert(Breakpoints.end(), {set.a, set.b, set.c, set.d});
+            }
+            std::sort(Breakpoints.begin(), Breakpoints.end());
+            Breakpoints.erase(std::unique(Breakpoints.begin(), Breakpoints.end()), Breakpoints.end());
+
+            Intervals.assign(Breakpoints.empty() ? 0 : Breakpoints.size() - 1, ActiveTerms<TermCount>());
+            for (std::size_t i = 0; i < Intervals.size(); ++i) {
+                for (std::size_t term = 0; term < TermCount; ++term) {
+                    if (sets[term].a <= Breakpoints[i] && sets[term].d >= Breakpoints[i + 1]) {
+                        Intervals[i].Terms[Intervals[i].Count++] = term;
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Index of the interval containing x, or -1 outside the partition (or for NaN).
+         */
+        std::ptrdiff_t locate(double x) const {
+            if (!(x >= Breakpoints.front() && x < Breakpoints.back())) return -1;
+            return std::upper_bound(Breakpoints.begin(), Breakpoints.end(), x) - Breakpoints.begin() - 1;
+        }
+
+        const ActiveTerms<TermCount>& find(double x) const {
+            std::ptrdiff_t interval = locate(x);
+            return interval < 0 ? None : Intervals[static_cast<std::size_t>(interval)];
+        }
+
+        const std::vector<double>& getBreakpoints() const { return Breakpoints; }
+        const ActiveTerms<TermCount>& getInterval(std::size_t i) const { return Intervals[i]; }
+        std::size_t getIntervalCount() const { return Intervals.size(); }
+    };
+
+} // namespace FDSHA
+
+#endif // TERMPARTITION_H
@@ -0,0 +1,106 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace FDSHA {
+
+    ThreadPool::ThreadPool(std::size_t threadCount) {
+        if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+        for (std::size_t i = 0; i < threadCount; ++i) Queues.push_back(std::make_unique<WorkerQueue>());
+        for (std::size_t i = 0; i < threadCount; ++i) Workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(StateMutex);
+            Stopping = true;
+        }
+        WakeUp.notify_all();
+        for (auto& worker : Workers) worker.join();
+    }
+
+    void ThreadPool::run(std::size_t taskCount, const TaskBody& body) {
+        if (taskCount == 0) return;
+        std::lock_guard<std::mutex> runLock(RunMutex);
+
+        std::unique_lock<std::mutex> lock(StateMutex);
+
+        // Deal contiguous chunks so neighbouring tasks (and their data) stay on one worker.
+        // Queuing under StateMutex keeps the tasks and Body of a generation consistent for the workers.
+        std::size_t workerCount = Workers.size();
+        for (std::size_t w = 0; w < workerCount; ++w) {
+            std::size_t begin = taskCount * w / workerCount;
+            std::size_t end = taskCount * (w + 1) / workerCount;
+            std::lock_guard<std::mutex> queueLock(Queues[w]->Mutex);
+            for (std::size_t task = begin; task < end; ++task) Queues[w]->Tasks.push_back(task);
+        }
+
+        Body = &body;
+        FirstError = nullptr;
+        Remaining.store(taskCount);
+        ++Generation;
+        WakeUp.notify_all();
+
+        // Wait for the last task and for every worker to leave its loop, so none can carry this
+        // Body into the next run()
+        Finished.wait(lock, [this] { return Remaining.load() == 0 && ActiveWorkers == 0; });
+        Body = nullptr;
+
+        if (FirstError) std::rethrow_exception(FirstError);
+    }
+
+    bool ThreadPool::popTask(std::size_t worker, std::size_t& task) {
+        {
+            WorkerQueue& own = *Queues[worker];
+            std::lock_guard<std::mutex> lock(own.Mutex);
+            if (!own.Tasks.empty()) {
+                task = own.Tasks.front();
+                own.Tasks.pop_front();
+                return true;
+            }
+        }
+        // Steal from the far end of another worker's queue
+        for (std::size_t k = 1; k < Queues.size(); ++k) {
+            WorkerQueue& victim = *Queues[(worker + k) % Queues.size()];
+            std::lock_guard<std::mutex> lock(victim.Mutex);
+            if (!victim.Tasks.empty()) {
+                task = victim.Tasks.back();
+                victim.Tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ThreadPool::workerLoop(std::size_t worker) {
+        std::size_t seenGeneration = 0;
+        for (;;) {
+            const TaskBody* body;
+            {
+                std::unique_lock<std::mutex> lock(StateMutex);
+                WakeUp.wait(lock, [&] { return Stopping || Generation != seenGeneration; });
+                if (Stopping) return;
+                seenGeneration = Generation;
+                body = Body;
+                // Woke after that run() already finished: wait for the next generation
+                if (body == nullptr) continue;
+                ++ActiveWorkers;
+            }
+
+            // All tasks of a generation are queued before it starts, so an empty sweep means done
+            std::size_t task;
+            while (popTask(worker, task)) {
+                try {
+                    (*body)(task, worker);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(StateMutex);
+                    if (!FirstError) FirstError = std::current_exception();
+                }
+                Remaining.fetch_sub(1);
+            }
+
+            std::lock_guard<std::mutex> lock(StateMutex);
+            if (--ActiveWorkers == 0 && Remaining.load() == 0) Finished.notify_all();
+        }
+    }
+
+} // namespace FDSHA
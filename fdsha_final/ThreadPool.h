@@ -0,0 +1,73 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace FDSHA {
+
+    /**
+     * @brief Fixed-size work-stealing thread pool for data-parallel loops.
+     *
+     * run() deals the task indices out to per-worker queues in contiguous chunks. Each worker
+     * drains its own queue from the front and, once empty, steals from the back of the others,
+     * so uneven tiles (e.g. sites with many nearby faults) balance out without a central queue.
+     */
+    class ThreadPool {
+    public:
+        // Task body: (task index, worker index in [0, size()))
+        using TaskBody = std::function<void(std::size_t, std::size_t)>;
+
+        /**
+         * @brief Starts threadCount workers (0 = one per hardware thread).
+         */
+        explicit ThreadPool(std::size_t threadCount = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        std::size_t size() const { return Workers.size(); }
+
+        /**
+         * @brief Runs body for every task in [0, taskCount) and returns once all have finished.
+         *
+         * The first exception thrown by a task is rethrown here after the loop completes.
+         */
+        void run(std::size_t taskCount, const TaskBody& body);
+
+    private:
+        struct WorkerQueue {
+            std::mutex Mutex;
+            std::deque<std::size_t> Tasks;
+        };
+
+        std::vector<std::thread> Workers;
+        std::vector<std::unique_ptr<WorkerQueue>> Queues;
+
+        std::mutex RunMutex;                 // serializes run() calls
+        std::mutex StateMutex;
+        std::condition_variable WakeUp;
+        std::condition_variable Finished;
+        std::size_t Generation = 0;
+        std::size_t ActiveWorkers = 0;       // workers currently draining queues
+        bool Stopping = false;
+
+        const TaskBody* Body = nullptr;
+        std::atomic<std::size_t> Remaining{0};
+        std::exception_ptr FirstError;
+
+        void workerLoop(std::size_t worker);
+        bool popTask(std::size_t worker, std::size_t& task);
+    };
+
+} // namespace FDSHA
+
+#endif // THREADPOOL_H
@@ -0,0 +1,386 @@
+// Benchmark suite for the FDSHA inference pipeline.
+//
+// Times each stage (fuzzify / infer / defuzzify) and end-to-end inference over fixed, random and
+// zero-firing input distributions, and writes one JSON document with ns/op, ops/s and heap
+// allocations per operation for every case.
+//
+// Build from fdsha_final/:
+//   g++ -std=c++17 -O2 -pthread -I. bench/Benchmark.cpp $(ls *.cpp | grep -v main.cpp) -o fdsha_bench
+// Usage:
+//   ./fdsha_bench [--min-time SECONDS] [--filter SUBSTRING] > results.json
+
+#include "FDSHAEngine.h"
+#include "PGACache.h"
+#include "PrecisionEngine.h"
+#include "ResponseSurface.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace FDSHA;
+
+// --- Allocation Counting ---
+// Every global operator new bumps this counter, so a case can report heap allocations per op.
+static std::atomic<std::size_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+    // Keeps results observable so the optimizer cannot drop the measured work
+    volatile double sink = 0.0;
+
+    struct Result {
+        std::string Name;
+        std::size_t Operations;
+        double Seconds;
+        std::size_t Allocations;
+        double MaxDeviation = -1.0;  // vs the reference configuration, when measured
+        double MeanDeviation = 0.0;
+    };
+
+    struct Options {
+        double MinTime = 0.25;
+        std::string Filter;
+    };
+
+    // Input sets, structure-of-arrays
+    struct Inputs {
+        std::vector<double> Mmax, R, F;
+        std::size_t size() const { return Mmax.size(); }
+    };
+
+    const std::size_t INPUT_COUNT = 4096;
+
+    Inputs fixedInputs() {
+        return {std::vector<double>(INPUT_COUNT, 6.7), std::vector<double>(INPUT_COUNT, 50.0), std::vector<double>(INPUT_COUNT, 0.0)};
+    }
+
+    // Uniform over the engine's universes, slightly widened so out-of-universe values show up
+    Inputs randomInputs(const FDSHAEngine& engine, std::uint32_t seed) {
+        std::mt19937 generator(seed);
+        Universe m = engine.getMagnitudeUniverse(), r = engine.getDistanceUniverse(), f = engine.getFaultTypeUniverse();
+        std::uniform_real_distribution<double> mmax(m.Min - 0.1, m.Max + 0.1), distance(r.Min, r.Max + 5.0), fault(f.Min - 0.01, f.Max + 0.01);
+        Inputs inputs;
+        for (std::size_t i = 0; i < INPUT_COUNT; ++i) {
+            inputs.Mmax.push_back(mmax(generator));
+            inputs.R.push_back(distance(generator));
+            inputs.F.push_back(fault(generator));
+        }
+        return inputs;
+    }
+
+    // Scenario-style inputs that repeat: Mmax in 0.1 steps, R in 0.1 km steps, three fault types
+    Inputs catalogInputs(std::uint32_t seed) {
+        std::mt19937 generator(seed);
+        std::uniform_int_distribution<int> mmax(55, 80), distance(0, 500), fault(-1, 1);
+        Inputs inputs;
+        for (std::size_t i = 0; i < INPUT_COUNT; ++i) {
+            inputs.Mmax.push_back(mmax(generator) / 10.0);
+            inputs.R.push_back(distance(generator) / 10.0);
+            inputs.F.push_back(fault(generator) / 10.0);
+        }
+        return inputs;
+    }
+
+    // Sources past the distance horizon: no rule fires and the defuzzifier falls back
+    Inputs zeroFiringInputs(const FDSHAEngine& engine, std::uint32_t seed) {
+        Inputs inputs = randomInputs(engine, seed);
+        std::mt19937 generator(seed + 1);
+        std::uniform_real_distribution<double> distance(engine.getDistanceHorizon(), 2.0 * engine.getDistanceHorizon());
+        for (double& r : inputs.R) r = distance(generator);
+        return inputs;
+    }
+
+    class Runner {
+    private:
+        Options Settings;
+        std::vector<Result> Results;
+
+    public:
+        explicit Runner(Options options) : Settings(std::move(options)) {}
+
+        /**
+         * @brief Repeats body (which performs opsPerCall operations) until MinTime has elapsed.
+         */
+        bool run(const std::string& name, std::size_t opsPerCall, const std::function<void()>& body) {
+            if (!Settings.Filter.empty() && name.find(Settings.Filter) == std::string::npos) return false;
+            body(); // warm-up
+
+            using Clock = std::chrono::steady_clock;
+            std::size_t calls = 0;
+            std::size_t allocationsBefore = allocationCount.load();
+            Clock::time_point start = Clock::now();
+            double elapsed = 0.0;
+            do {
+                body();
+                ++calls;
+                elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            } while (elapsed < Settings.MinTime);
+            std::size_t allocations = allocationCount.load() - allocationsBefore;
+
+            Results.push_back({name, calls * opsPerCall, elapsed, allocations});
+            std::fprintf(stderr, "%-44s %10.1f ns/op\n", name.c_str(), 1e9 * elapsed / static_cast<double>(calls * opsPerCall));
+            return true;
+        }
+
+        /**
+         * @brief Attaches the output deviation from the reference configuration to the last case.
+         */
+        void setDeviation(double maxDeviation, double meanDeviation) {
+            Results.back().MaxDeviation = maxDeviation;
+            Results.back().MeanDeviation = meanDeviation;
+            std::fprintf(stderr, "%-44s %10.4f max |dPGA|, %.4f mean\n", "", maxDeviation, meanDeviation);
+        }
+
+        void report(const FDSHAEngine& engine, std::FILE* out) const {
+            const char* simd[] = {"scalar", "sse2", "avx2"};
+            std::fprintf(out, "{\n  \"simd_level\": \"%s\",\n  \"sample_count\": %d,\n  \"hardware_threads\": %u,\n  \"results\": [\n",
+                         simd[static_cast<int>(engine.getSimdLevel())], engine.getSampleCount(), std::thread::hardware_concurrency());
+            for (std::size_t i = 0; i < Results.size(); ++i) {
+                const Result& r = Results[i];
+                double ops = static_cast<double>(r.Operations);
+                std::fprintf(out, "    {\"name\": \"%s\", \"operations\": %zu, \"ns_per_op\": %.3f, \"ops_per_s\": %.1f, \"allocs_per_op\": %.4f",
+                             r.Name.c_str(), r.Operations, 1e9 * r.Seconds / ops, ops / r.Seconds, static_cast<double>(r.Allocations) / ops);
+                if (r.MaxDeviation >= 0.0) {
+                    std::fprintf(out, ", \"max_deviation\": %.6g, \"mean_deviation\": %.6g", r.MaxDeviation, r.MeanDeviation);
+                }
+                std::fprintf(out, "}%s\n", i + 1 < Results.size() ? "," : "");
+            }
+            std::fprintf(out, "  ]\n}\n");
+        }
+    };
+
+    // Scalar end-to-end and per-stage cases for one engine configuration
+    void benchmarkScalar(Runner& runner, const FDSHAEngine& engine, const std::string& prefix, const Inputs& inputs) {
+        std::size_t n = inputs.size();
+
+        runner.run(prefix + "/findPGA", n, [&] {
+            double sum = 0.0;
+            for (std::size_t i = 0; i < n; ++i) sum += engine.findPGA(inputs.Mmax[i], inputs.R[i], inputs.F[i]);
+            sink = sum;
+        });
+        runner.run(prefix + "/findPGABatch", n, [&] {
+            static thread_local std::vector<double> out(INPUT_COUNT);
+            engine.findPGABatch(inputs.Mmax.data(), inputs.R.data(), inputs.F.data(), out.data(), n);
+            sink = out[0];
+        });
+    }
+
+    void benchmarkStages(Runner& runner, const FDSHAEngine& engine, const std::string& prefix, const Inputs& inputs) {
+        std::size_t n = inputs.size();
+        std::vector<FuzzifiedInputs> fuzzified(n);
+        std::vector<PGAStrengths> strengths(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            fuzzified[i] = engine.fuzzify(inputs.Mmax[i], inputs.R[i], inputs.F[i]);
+            strengths[i] = engine.infer(fuzzified[i]);
+        }
+
+        runner.run(prefix + "/stage/fuzzify", n, [&] {
+            double sum = 0.0;
+            for (std::size_t i = 0; i < n; ++i) sum += engine.fuzzify(inputs.Mmax[i], inputs.R[i], inputs.F[i]).R.Degrees[0];
+            sink = sum;
+        });
+        runner.run(prefix + "/stage/infer", n, [&] {
+            double sum = 0.0;
+            for (std::size_t i = 0; i < n; ++i) sum += engine.infer(fuzzified[i])[0];
+            sink = sum;
+        });
+        runner.run(prefix + "/stage/defuzzify", n, [&] {
+            double sum = 0.0;
+            for (std::size_t i = 0; i < n; ++i) sum += engine.defuzzify(strengths[i]);
+            sink = sum;
+        });
+    }
+
+    // One compile-time policy set: throughput and output deviation from findPGA (min/max/sampled COG)
+    template <class TNorm, class Aggregation, class Defuzzifier>
+    void benchmarkPolicies(Runner& runner, const FDSHAEngine& engine, const std::string& name, const Inputs& inputs) {
+        std::size_t n = inputs.size();
+        bool ran = runner.run("sampled/random/findPGAWith/" + name, n, [&] {
+            double sum = 0.0;
+            for (std::size_t i = 0; i < n; ++i) {
+                sum += engine.findPGAWith<TNorm, Aggregation, Defuzzifier>(inputs.Mmax[i], inputs.R[i], inputs.F[i]);
+            }
+            sink = sum;
+        });
+        if (!ran) return;
+
+        double maxDeviation = 0.0;
+        double totalDeviation = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            double deviation = std::fabs(engine.findPGAWith<TNorm, Aggregation, Defuzzifier>(inputs.Mmax[i], inputs.R[i], inputs.F[i])
+                                         - engine.findPGA(inputs.Mmax[i], inputs.R[i], inputs.F[i]));
+            maxDeviation = std::max(maxDeviation, deviation);
+            totalDeviation += deviation;
+        }
+        runner.setDeviation(maxDeviation, totalDeviation / static_cast<double>(n));
+    }
+
+    // One shared const engine driven from every hardware thread; also verifies determinism
+    bool benchmarkConcurrent(Runner& runner, const FDSHAEngine& engine, const std::string& prefix, const Inputs& inputs) {
+        std::size_t n = inputs.size();
+        std::vector<double> expected(n);
+        for (std::size_t i = 0; i < n; ++i) expected[i] = engine.findPGA(inputs.Mmax[i], inputs.R[i], inputs.F[i]);
+
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+        std::atomic<std::size_t> mismatches{0};
+        runner.run(prefix + "/findPGA/threads=" + std::to_string(threads), n * threads, [&] {
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.emplace_back([&] {
+                    std::size_t bad = 0;
+                    for (std::size_t i = 0; i < n; ++i) bad += engine.findPGA(inputs.Mmax[i], inputs.R[i], inputs.F[i]) != expected[i];
+                    mismatches += bad;
+                });
+            }
+            for (auto& worker : workers) worker.join();
+        });
+        if (mismatches.load() != 0) std::fprintf(stderr, "%s: %zu non-deterministic results\n", prefix.c_str(), mismatches.load());
+        return mismatches.load() == 0;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--min-time" && i + 1 < argc) {
+            options.MinTime = std::atof(argv[++i]);
+        } else if (arg == "--filter" && i + 1 < argc) {
+            options.Filter = argv[++i];
+        } else {
+            std::fprintf(stderr, "Usage: %s [--min-time SECONDS] [--filter SUBSTRING]\n", argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    Runner runner(options);
+    FDSHAEngine sampled;
+    FDSHAEngine exact;
+    exact.setDefuzzificationMethod(DefuzzificationMethod::ExactCenterOfGravity);
+
+    const Inputs fixed = fixedInputs();
+    const Inputs random = randomInputs(sampled, 42);
+    const Inputs zeroFiring = zeroFiringInputs(sampled, 43);
+
+    // The sampled-COG engine is the reference configuration every fast path is compared against
+    struct Case { const char* Name; const Inputs* Data; };
+    for (const Case& c : {Case{"fixed", &fixed}, Case{"random", &random}, Case{"zero_firing", &zeroFiring}}) {
+        benchmarkScalar(runner, sampled, std::string("sampled/") + c.Name, *c.Data);
+        benchmarkScalar(runner, exact, std::string("exact/") + c.Name, *c.Data);
+    }
+    benchmarkStages(runner, sampled, "sampled/random", random);
+    benchmarkStages(runner, exact, "exact/random", random);
+
+    // Inference operator policies (the first is the default configuration)
+    benchmarkPolicies<MinimumTNorm, MaximumAggregation, CenterOfGravity>(runner, sampled, "min/max/cog", random);
+    benchmarkPolicies<MinimumTNorm, SumAggregation, CenterOfGravity>(runner, sampled, "min/sum/cog", random);
+    benchmarkPolicies<ProductTNorm, MaximumAggregation, CenterOfGravity>(runner, sampled, "product/max/cog", random);
+    benchmarkPolicies<ProductTNorm, SumAggregation, CenterOfGravity>(runner, sampled, "product/sum/cog", random);
+    benchmarkPolicies<MinimumTNorm, MaximumAggregation, WeightedAverage>(runner, sampled, "min/max/weighted_average", random);
+    benchmarkPolicies<ProductTNorm, SumAggregation, WeightedAverage>(runner, sampled, "product/sum/weighted_average", random);
+
+    // Batch kernels per instruction set
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+        if (level > detectSimdLevel()) continue;
+        const char* names[] = {"scalar", "sse2", "avx2"};
+        FDSHAEngine engine = sampled;
+        engine.setSimdLevel(level);
+        runner.run(std::string("sampled/random/findPGABatch/simd=") + names[static_cast<int>(level)], random.size(), [&] {
+            static thread_local std::vector<double> out(INPUT_COUNT);
+            engine.findPGABatch(random.Mmax.data(), random.R.data(), random.F.data(), out.data(), random.size());
+            sink = out[0];
+        });
+    }
+
+    // Reduced-precision engines (float on its SIMD kernels, Q15.16 fixed point on portable loops)
+    const PrecisionEngine<float> singlePrecision(FuzzyModel::builtin());
+    const PrecisionEngine<Fixed32> fixedPoint(FuzzyModel::builtin());
+    runner.run("sampled/random/findPGABatch/precision=float", random.size(), [&] {
+        static thread_local std::vector<double> out(INPUT_COUNT);
+        singlePrecision.findPGABatch(random.Mmax.data(), random.R.data(), random.F.data(), out.data(), random.size());
+        sink = out[0];
+    });
+    runner.run("sampled/random/findPGABatch/precision=fixed32", random.size(), [&] {
+        static thread_local std::vector<double> out(INPUT_COUNT);
+        fixedPoint.findPGABatch(random.Mmax.data(), random.R.data(), random.F.data(), out.data(), random.size());
+        sink = out[0];
+    });
+
+    // Memo table on repeating inputs (warm after the first call) against the bare engine
+    const Inputs catalog = catalogInputs(44);
+    const PGACache cache(sampled);
+    runner.run("sampled/catalog/findPGA", catalog.size(), [&] {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < catalog.size(); ++i) sum += sampled.findPGA(catalog.Mmax[i], catalog.R[i], catalog.F[i]);
+        sink = sum;
+    });
+    runner.run("sampled/catalog/findPGA/cache", catalog.size(), [&] {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < catalog.size(); ++i) sum += cache.findPGA(catalog.Mmax[i], catalog.R[i], catalog.F[i]);
+        sink = sum;
+    });
+    runner.run("sampled/catalog/findPGABatch/cache", catalog.size(), [&] {
+        static thread_local std::vector<double> out(INPUT_COUNT);
+        cache.findPGABatch(catalog.Mmax.data(), catalog.R.data(), catalog.F.data(), out.data(), catalog.size());
+        sink = out[0];
+    });
+
+    // Tabulated fast path
+    ResponseSurface surface = ResponseSurface::build(exact, 81, 201, 41);
+    runner.run("surface/random/findPGA", random.size(), [&] {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < random.size(); ++i) sum += surface.findPGA(random.Mmax[i], random.R[i], random.F[i]);
+        sink = sum;
+    });
+
+    // Attenuation curve: R swept over [0, 200) km with Mmax and F fixed, against one findPGA per point
+    std::vector<double> curve(1000);
+    for (std::size_t i = 0; i < curve.size(); ++i) curve[i] = 0.2 * static_cast<double>(i);
+    for (const FDSHAEngine* engine : {&sampled, &exact}) {
+        std::string prefix = engine == &sampled ? "sampled" : "exact";
+        runner.run(prefix + "/curve/findPGASweep", curve.size(), [&] {
+            static thread_local std::vector<double> out(1000);
+            engine->findPGASweep(InputAxis::Distance, 6.7, 0.0, 0.02, curve.data(), out.data(), curve.size());
+            sink = out[0];
+        });
+        runner.run(prefix + "/curve/findPGA", curve.size(), [&] {
+            double sum = 0.0;
+            for (double r : curve) sum += engine->findPGA(6.7, r, 0.02);
+            sink = sum;
+        });
+    }
+
+    // Inverse queries: threshold distance per source, against the inputs of the random set
+    runner.run("sampled/random/findExceedanceIntervalsBatch/R", 256, [&] {
+        static thread_local std::vector<ExceedanceIntervals> results(256);
+        sampled.findExceedanceIntervalsBatch(InputAxis::Distance, 0.25, random.Mmax.data(), nullptr, random.F.data(), results.data(), 256);
+        sink = static_cast<double>(results[0].Evaluations);
+    });
+
+    bool deterministic = benchmarkConcurrent(runner, sampled, "sampled/random", random)
+                       & benchmarkConcurrent(runner, exact, "exact/random", random);
+
+    runner.report(sampled, stdout);
+    return deterministic ? 0 : 1;
+}
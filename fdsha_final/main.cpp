@@ -1,8 +1,30 @@
 #include "FDSHAEngine.h"
+#include "EngineHandle.h"
+#include "HazardMap.h"
+#include "HazardLevels.h"
+#include "HazardRaster.h"
+#include "LoadGenerator.h"
+#include "PGAServer.h"
+#include "Instrumentation.h"
+#include "MonteCarlo.h"
+#include "PGACache.h"
+#include "PrecisionEngine.h"
+#include "ResponseSurface.h"
+#include <fstream>
 #include <iostream>
 #include <limits>
 #include <cctype>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace FDSHA;
 
@@ -17,27 +39,957 @@ void safeInput(double& value, const std::string& prompt) {
     }
 }
 
-// provide a qualitative verdict based on the crisp PGA value
-std::string getPGAVerdict(double pga) {
-    if (pga < 0.10) {
-        return "Negligible (Very Low Hazard)";
-    } else if (pga < 0.25) {
-        return "Low (Minor Structural Risk)";
-    } else if (pga < 0.45) {
-        return "Moderate (Significant Damage Likely)";
-    } else if (pga < 0.65) {
-        return "High/Much (Major Structural Damage Expected)";
-    } else if (pga < 0.80) {
-        return "Very High/Very Much (Severe Damage, Near Collapse)";
-    } else {
-        return "Extreme/Very Very Much (Maximum Hazard, Catastrophic Damage)";
+// --- Batch Mode ---
+// Streams "Mmax,R,F[,id]" rows to "id,PGA,verdict" rows. Input and output go through fixed-size
+// buffers and rows are scored in blocks through findPGABatch, so memory use does not grow with input size.
+namespace {
+
+    const std::size_t IO_BUFFER_SIZE = 1 << 20;
+    const std::size_t ROW_BLOCK_SIZE = 4096;
+
+    struct RowBlock {
+        std::vector<double> Mmax, R, F, PGA;
+        std::string Ids;                   // ids of the block, concatenated
+        std::vector<std::size_t> IdEnds;   // end offset of each id in Ids
+
+        void clear() {
+            Mmax.clear(); R.clear(); F.clear();
+            Ids.clear(); IdEnds.clear();
+        }
+        std::size_t size() const { return Mmax.size(); }
+    };
+
+    class OutputBuffer {
+    private:
+        std::FILE* Out;
+        std::vector<char> Buffer;
+        std::size_t Used = 0;
+        bool Failed = false;   // a write came up short (full disk, closed pipe)
+
+        void write(const char* data, std::size_t length) {
+            if (std::fwrite(data, 1, length, Out) != length) Failed = true;
+        }
+
+    public:
+        explicit OutputBuffer(std::FILE* out) : Out(out), Buffer(IO_BUFFER_SIZE) {}
+        ~OutputBuffer() { flush(); }
+
+        void flush() {
+            if (Used > 0) write(Buffer.data(), Used);
+            Used = 0;
+        }
+
+        // Flushes the buffer and the stream; returns false if any write failed
+        bool finish() {
+            flush();
+            if (std::fflush(Out) != 0) Failed = true;
+            return !Failed && !std::ferror(Out);
+        }
+
+        // Room for the fixed-size fields of a row (numbers, verdict, separators); text of any length
+        // goes through the length-checked append(const char*, size_t)
+        void reserveRow() {
+            if (Buffer.size() - Used < 512) flush();
+        }
+
+        void append(const char* text, std::size_t length) {
+            if (length > Buffer.size() - Used) {
+                flush();
+                if (length > Buffer.size()) {
+                    write(text, length);
+                    return;
+                }
+            }
+            std::memcpy(Buffer.data() + Used, text, length);
+            Used += length;
+        }
+
+        void append(double value) {
+            auto result = std::to_chars(Buffer.data() + Used, Buffer.data() + Buffer.size(), value);
+            Used = static_cast<std::size_t>(result.ptr - Buffer.data());
+        }
+
+        void append(char c) { Buffer[Used++] = c; }
+    };
+
+    // Exit status of a mode that wrote out: 1 if the output could not be written, else status
+    int finishOutput(OutputBuffer& out, int status) {
+        if (out.finish()) return status;
+        std::fprintf(stderr, "Error while writing output\n");
+        return 1;
+    }
+
+    const char* skipSpaces(const char* p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\t')) ++p;
+        return p;
+    }
+
+    // Parses one comma-separated number; returns nullptr if the field is not a number
+    const char* parseField(const char* p, const char* end, double& value) {
+        p = skipSpaces(p, end);
+        if (p < end && *p == '+') ++p;
+        auto result = std::from_chars(p, end, value);
+        if (result.ec != std::errc()) return nullptr;
+        p = skipSpaces(result.ptr, end);
+        if (p < end && *p != ',') return nullptr;
+        return p;
+    }
+
+    // Adds one row to the block; returns false for a malformed row
+    bool parseRow(const char* p, const char* end, std::size_t rowNumber, RowBlock& block) {
+        double mmax, r, f;
+        if (!(p = parseField(p, end, mmax)) || p == end) return false;
+        if (!(p = parseField(p + 1, end, r)) || p == end) return false;
+        if (!(p = parseField(p + 1, end, f))) return false;
+
+        if (p < end) {
+            const char* idBegin = skipSpaces(p + 1, end);
+            const char* idEnd = end;
+            while (idEnd > idBegin && (idEnd[-1] == ' ' || idEnd[-1] == '\t')) --idEnd;
+            block.Ids.append(idBegin, static_cast<std::size_t>(idEnd - idBegin));
+        } else {
+            char digits[24];
+            auto result = std::to_chars(digits, digits + sizeof(digits), rowNumber);
+            block.Ids.append(digits, static_cast<std::size_t>(result.ptr - digits));
+        }
+        block.IdEnds.push_back(block.Ids.size());
+        block.Mmax.push_back(mmax);
+        block.R.push_back(r);
+        block.F.push_back(f);
+        return true;
+    }
+
+    void writeBlock(const FDSHAEngine& engine, const PGACache* cache, const ResponseSurface* surface, RowBlock& block,
+                    OutputBuffer& out) {
+        block.PGA.resize(block.size());
+        if (surface != nullptr) {
+            for (std::size_t i = 0; i < block.size(); ++i) block.PGA[i] = surface->findPGA(block.Mmax[i], block.R[i], block.F[i]);
+        } else if (cache != nullptr) {
+            cache->findPGABatch(block.Mmax.data(), block.R.data(), block.F.data(), block.PGA.data(), block.size());
+        } else engine.findPGABatch(block.Mmax.data(), block.R.data(), block.F.data(), block.PGA.data(), block.size());
+
+        std::size_t idBegin = 0;
+        for (std::size_t i = 0; i < block.size(); ++i) {
+            // Ids can be as long as an input line, so the fixed-size rest of the row is reserved after it
+            out.append(block.Ids.data() + idBegin, block.IdEnds[i] - idBegin);
+            out.reserveRow();
+            out.append(',');
+            out.append(block.PGA[i]);
+            out.append(',');
+            // Verdicts may contain commas, so they are always quoted
+            const char* verdict = getPGAVerdict(block.PGA[i]);
+            out.append('"');
+            out.append(verdict, std::strlen(verdict));
+            out.append('"');
+            out.append('\n');
+            idBegin = block.IdEnds[i];
+        }
+        block.clear();
+    }
+
+    // Set by SIGHUP; --batch reloads the --model file before the next row block
+    volatile std::sig_atomic_t reloadRequested = 0;
+
+    void requestReload(int) { reloadRequested = 1; }
+
+    // Swaps in the re-read model; a broken file keeps the current one serving
+    void reloadModel(EngineHandle& engines, const char* modelPath) {
+        reloadRequested = 0;
+        try {
+            engines.swapModel(FuzzyModel::load(modelPath));
+            std::fprintf(stderr, "Reloaded model %s\n", modelPath);
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "Keeping the current model: %s\n", e.what());
+        }
+    }
+
+    // Set by SIGUSR1; --batch writes the engine statistics before the next row block
+    volatile std::sig_atomic_t statisticsRequested = 0;
+
+    void requestStatistics(int) { statisticsRequested = 1; }
+
+    // --cache: memo table in front of the engine in use, rebuilt when a reload publishes a new one
+    class BatchCache {
+    private:
+        const CacheSettings* Settings;
+        std::shared_ptr<const FDSHAEngine> Engine;
+        std::unique_ptr<PGACache> Cache;
+        CacheStatistics Retired; // totals of caches dropped on reload
+
+    public:
+        explicit BatchCache(const CacheSettings* settings) : Settings(settings) {}
+
+        const PGACache* get(const std::shared_ptr<const FDSHAEngine>& engine) {
+            if (Settings == nullptr) return nullptr;
+            if (engine != Engine) {
+                Retired = getStatistics();
+                Retired.Entries = 0;
+                Cache = std::make_unique<PGACache>(*engine, *Settings);
+                Engine = engine;
+            }
+            return Cache.get();
+        }
+
+        CacheStatistics getStatistics() const {
+            CacheStatistics statistics = Retired;
+            if (Cache == nullptr) return statistics;
+            CacheStatistics current = Cache->getStatistics();
+            statistics.Hits += current.Hits;
+            statistics.Misses += current.Misses;
+            statistics.Evictions += current.Evictions;
+            statistics.Bypasses += current.Bypasses;
+            statistics.Entries = current.Entries;
+            return statistics;
+        }
+    };
+
+    // Probes per axis when a built surface is checked against the engine (80^3, under a second)
+    const std::size_t SURFACE_ERROR_PROBES = 80;
+
+    // --surface: how the response surface is obtained
+    struct SurfaceOptions {
+        bool Load = false;                      // map Path instead of tabulating and writing it
+        std::string Path;
+        std::size_t Points[3] = {81, 201, 41};  // Mmax, R, F grid points when tabulating
+    };
+
+    // Response surface of the engine in use; re-tabulated (or re-mapped) when a reload publishes a new one
+    class BatchSurface {
+    private:
+        const SurfaceOptions* Options;
+        std::shared_ptr<const FDSHAEngine> Engine;
+        std::unique_ptr<ResponseSurface> Surface;
+
+        ResponseSurface tabulate(const FDSHAEngine& engine) const {
+            if (Options->Load) {
+                ResponseSurface surface = ResponseSurface::load(Options->Path, engine);
+                std::fprintf(stderr, "Loaded response surface %s\n", Options->Path.c_str());
+                return surface;
+            }
+            ResponseSurface surface = ResponseSurface::build(engine, Options->Points[0], Options->Points[1], Options->Points[2]);
+            surface.save(Options->Path);
+            std::fprintf(stderr, "Tabulated a %zux%zux%zu response surface into %s\n", Options->Points[0], Options->Points[1],
+                         Options->Points[2], Options->Path.c_str());
+            SurfaceErrorReport error = surface.measureError(engine, SURFACE_ERROR_PROBES);
+            std::fprintf(stderr, "Interpolation error over %zu probes: max %.3g g, mean %.3g g\n", error.Samples,
+                         error.MaxAbsError, error.MeanAbsError);
+            return surface;
+        }
+
+    public:
+        explicit BatchSurface(const SurfaceOptions* options) : Options(options) {}
+
+        // Throws when the first engine's surface cannot be built, written or loaded. After a reload,
+        // a failure is reported and the new engine is scored exactly instead.
+        const ResponseSurface* get(const std::shared_ptr<const FDSHAEngine>& engine) {
+            if (Options == nullptr) return nullptr;
+            if (engine != Engine) {
+                bool initial = Engine == nullptr;
+                Surface.reset();
+                Engine = engine;
+                try {
+                    Surface = std::make_unique<ResponseSurface>(tabulate(*engine));
+                } catch (const std::exception& e) {
+                    if (initial) throw;
+                    std::fprintf(stderr, "Scoring without the response surface: %s\n", e.what());
+                }
+            }
+            return Surface.get();
+        }
+    };
+
+} // namespace
+
+// --- Engine Statistics ---
+// Writes the counters collected so far (format "json" or "prometheus") to stderr
+void writeStatistics(const char* format) {
+    statisticsRequested = 0;
+    EngineStatistics statistics = Instrumentation::collect();
+    std::string text = std::strcmp(format, "prometheus") == 0 ? statistics.toPrometheus() : statistics.toJson();
+    std::fwrite(text.data(), 1, text.size(), stderr);
+    std::fflush(stderr);
+}
+
+int runBatch(EngineHandle& engines, const char* modelPath, const char* statisticsFormat, const CacheSettings* cacheSettings,
+             const SurfaceOptions* surfaceOptions, std::FILE* in) {
+    RowBlock block;
+    OutputBuffer out(stdout);
+    BatchCache cache(cacheSettings);
+    BatchSurface surface(surfaceOptions);
+    auto scoreBlock = [&] {
+        std::shared_ptr<const FDSHAEngine> engine = engines.acquire();
+        writeBlock(*engine, cache.get(engine), surface.get(engine), block, out);
+    };
+    // Bad cache settings or an unusable surface throw before any output
+    cache.get(engines.acquire());
+    surface.get(engines.acquire());
+    std::vector<char> buffer(IO_BUFFER_SIZE);
+    std::size_t pending = 0;      // bytes of an unfinished line carried over from the last read
+    std::size_t lineNumber = 0;
+    std::size_t rowNumber = 0;
+    std::size_t rejected = 0;
+    bool eof = false;
+
+    const char header[] = "id,PGA,verdict\n";
+    out.append(header, sizeof(header) - 1);
+
+    while (!eof) {
+        std::size_t bytes = std::fread(buffer.data() + pending, 1, buffer.size() - pending, in);
+        eof = bytes == 0;
+        std::size_t available = pending + bytes;
+        // Terminate a final line that has no newline (pending < buffer size, so there is room)
+        if (eof && available > 0 && buffer[available - 1] != '\n') buffer[available++] = '\n';
+
+        const char* begin = buffer.data();
+        const char* end = begin + available;
+        const char* line = begin;
+        const char* newline;
+        while ((newline = static_cast<const char*>(std::memchr(line, '\n', static_cast<std::size_t>(end - line)))) != nullptr) {
+            const char* lineEnd = newline;
+            if (lineEnd > line && lineEnd[-1] == '\r') --lineEnd;
+            ++lineNumber;
+
+            // Blank lines and '#' comments are skipped
+            const char* first = skipSpaces(line, lineEnd);
+            if (first != lineEnd && *first != '#') {
+                if (parseRow(first, lineEnd, rowNumber + 1, block)) {
+                    ++rowNumber;
+                    if (block.size() == ROW_BLOCK_SIZE) {
+                        if (reloadRequested && modelPath != nullptr) reloadModel(engines, modelPath);
+                        if (statisticsRequested && statisticsFormat != nullptr) writeStatistics(statisticsFormat);
+                        scoreBlock();
+                    }
+                } else if (lineNumber != 1) {
+                    // A non-numeric first line is taken as a CSV header
+                    ++rejected;
+                    std::fprintf(stderr, "Skipping malformed row at line %zu\n", lineNumber);
+                }
+            }
+            line = newline + 1;
+        }
+
+        pending = static_cast<std::size_t>(end - line);
+        if (pending == buffer.size()) {
+            std::fprintf(stderr, "Line %zu is longer than %zu bytes\n", lineNumber + 1, buffer.size());
+            return 1;
+        }
+        std::memmove(buffer.data(), line, pending);
+    }
+
+    if (block.size() > 0) scoreBlock();
+    int status = finishOutput(out, rejected == 0 ? 0 : 2);
+    if (cacheSettings != nullptr) {
+        CacheStatistics statistics = cache.getStatistics();
+        std::fprintf(stderr, "Cache: %llu hits, %llu misses (%.1f%% hit rate), %llu evictions, %llu bypassed, %llu entries\n",
+                     static_cast<unsigned long long>(statistics.Hits), static_cast<unsigned long long>(statistics.Misses),
+                     100.0 * statistics.hitRate(), static_cast<unsigned long long>(statistics.Evictions),
+                     static_cast<unsigned long long>(statistics.Bypasses), static_cast<unsigned long long>(statistics.Entries));
+    }
+    if (std::ferror(in)) {
+        std::fprintf(stderr, "Error while reading input\n");
+        return 1;
+    }
+    return status;
+}
+
+// --- Server Mode ---
+// Serves PGA requests on a socket until SIGINT or SIGTERM; SIGHUP and SIGUSR1 work as in --batch.
+namespace {
+
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void requestStop(int) { stopRequested = 1; }
+
+} // namespace
+
+int runServer(EngineHandle& engines, const char* modelPath, const ServerSettings& settings, const char* statisticsFormat) {
+    PGAServer server(engines, settings);
+    try {
+        server.start();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
     }
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+#ifdef SIGHUP
+    if (modelPath != nullptr) std::signal(SIGHUP, requestReload);
+#endif
+#ifdef SIGUSR1
+    if (statisticsFormat != nullptr) std::signal(SIGUSR1, requestStatistics);
+#endif
+    std::cerr << "Serving on " << settings.Address << std::endl;
+
+    while (!stopRequested) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (reloadRequested && modelPath != nullptr) reloadModel(engines, modelPath);
+        if (statisticsRequested && statisticsFormat != nullptr) writeStatistics(statisticsFormat);
+    }
+
+    server.stop();
+    ServerCounters counters = server.getCounters();
+    std::cerr << "Served " << counters.Requests << " requests (" << counters.Rows << " rows) in " << counters.Batches
+              << " batches over " << counters.Connections << " connections" << std::endl;
+    return 0;
 }
 
-int main() {
+int runLoadGenerator(const LoadSettings& settings) {
+    LoadReport report;
+    try {
+        report = runLoad(settings);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    double seconds = std::max(report.Seconds, 1e-9);
+    std::cout << "statistic,value\n"
+              << "requests," << report.Requests << "\n"
+              << "rows," << report.Rows << "\n"
+              << "errors," << report.Errors << "\n"
+              << "seconds," << report.Seconds << "\n"
+              << "rows_per_s," << static_cast<double>(report.Rows) / seconds << "\n"
+              << "requests_per_s," << static_cast<double>(report.Requests) / seconds << "\n"
+              << "latency_p50_us," << report.LatencyP50 * 1e6 << "\n"
+              << "latency_p99_us," << report.LatencyP99 * 1e6 << "\n"
+              << "latency_p999_us," << report.LatencyP999 * 1e6 << "\n"
+              << "latency_max_us," << report.LatencyMax * 1e6 << std::endl;
+    return report.Errors == 0 ? 0 : 2;
+}
+
+// --- Hazard Map Mode ---
+// Reads a fault catalog of "lat,lon,Mmax,F[,id]" rows and writes "lat,lon,PGA,fault" rows for a site grid.
+bool loadFaultCatalog(const char* path, const FDSHAEngine& engine, std::vector<Fault>& faults, std::vector<std::string>& ids) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    std::size_t lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        const char* p = skipSpaces(line.data(), line.data() + line.size());
+        const char* end = line.data() + line.size();
+        if (p == end || *p == '#') continue;
+
+        Fault fault;
+        double* fields[4] = {&fault.Latitude, &fault.Longitude, &fault.Mmax, &fault.FaultType};
+        bool valid = true;
+        for (int i = 0; i < 4 && valid; ++i) {
+            p = parseField(i == 0 ? p : p + 1, end, *fields[i]);
+            valid = p != nullptr && (i == 3 || p != end);
+        }
+        if (!valid) {
+            if (lineNumber == 1) continue; // header
+            std::cerr << "Malformed fault at " << path << ":" << lineNumber << std::endl;
+            return false;
+        }
+        if (!std::isfinite(fault.Latitude) || !std::isfinite(fault.Longitude)) {
+            std::cerr << "Non-finite fault coordinates at " << path << ":" << lineNumber << std::endl;
+            return false;
+        }
+        // No rule fires for such a fault, so it could only ever contribute the empty-set fallback
+        if (!engine.isCovered(InputAxis::Magnitude, fault.Mmax) || !engine.isCovered(InputAxis::FaultType, fault.FaultType)) {
+            Universe m = engine.getMagnitudeUniverse(), f = engine.getFaultTypeUniverse();
+            std::cerr << "Fault at " << path << ":" << lineNumber << " is outside the model: Mmax " << fault.Mmax << " and F "
+                      << fault.FaultType << " must fall inside (" << m.Min << ", " << m.Max << ") and (" << f.Min << ", "
+                      << f.Max << ") where a set is non-zero" << std::endl;
+            return false;
+        }
+        faults.push_back(fault);
+        ids.push_back(p < end ? std::string(skipSpaces(p + 1, end), end) : std::to_string(faults.size()));
+    }
+    return true;
+}
+
+// Grid spec: "minLat,maxLat,minLon,maxLon,rows,cols"
+bool parseGridSpec(const char* spec, SiteGrid& grid) {
+    double values[6];
+    const char* p = spec;
+    const char* end = spec + std::strlen(spec);
+    for (int i = 0; i < 6; ++i) {
+        p = parseField(i == 0 ? p : p + 1, end, values[i]);
+        if (p == nullptr || (i < 5 && p == end)) return false;
+    }
+    if (p != end || !(values[4] >= 1) || !(values[5] >= 1)) return false;
+    for (double value : values) {
+        if (!std::isfinite(value)) return false;
+    }
+
+    grid.Rows = static_cast<std::size_t>(values[4]);
+    grid.Columns = static_cast<std::size_t>(values[5]);
+    grid.MinLatitude = values[0];
+    grid.MinLongitude = values[2];
+    grid.LatitudeStep = grid.Rows > 1 ? (values[1] - values[0]) / static_cast<double>(grid.Rows - 1) : 0.0;
+    grid.LongitudeStep = grid.Columns > 1 ? (values[3] - values[2]) / static_cast<double>(grid.Columns - 1) : 0.0;
+    return true;
+}
+
+// Raster output of --hazard-map (--raster FILE); an existing matching file is resumed
+struct RasterOptions {
+    const char* Path = nullptr;
+    std::size_t TileSize = 256;
+    bool FaultLayer = true;
+};
+
+int writeHazardRaster(const HazardMapGenerator& generator, const SiteGrid& grid, const RasterOptions& options, std::size_t threads) {
+    try {
+        HazardRasterWriter raster(options.Path, grid, RasterProvenance::of(generator), options.TileSize, options.FaultLayer);
+        std::size_t remaining = raster.getIncompleteTiles().size();
+        if (remaining < raster.getTileCount()) {
+            std::cerr << "Resuming " << options.Path << ": " << raster.getTileCount() - remaining << " of "
+                      << raster.getTileCount() << " tiles already complete" << std::endl;
+        }
+        ThreadPool pool(threads);
+        generator.generate(raster, pool);
+        std::cerr << "Wrote " << remaining << " tiles of " << options.TileSize << "x" << options.TileSize << " sites to "
+                  << options.Path << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Header and progress of a raster file as "statistic,value" rows
+int runRasterInfo(const char* path) {
+    HazardRaster raster;
+    try {
+        raster = HazardRaster::open(path);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    const SiteGrid& grid = raster.getGrid();
+    const RasterProvenance& provenance = raster.getProvenance();
+    std::cout.precision(17);
+    std::cout << "statistic,value\n"
+              << "rows," << grid.Rows << "\n"
+              << "columns," << grid.Columns << "\n"
+              << "min_latitude," << grid.MinLatitude << "\n"
+              << "min_longitude," << grid.MinLongitude << "\n"
+              << "latitude_step," << grid.LatitudeStep << "\n"
+              << "longitude_step," << grid.LongitudeStep << "\n"
+              << "tile_size," << raster.getTileSize() << "\n"
+              << "fault_layer," << (raster.hasFaultLayer() ? 1 : 0) << "\n"
+              << "model_fingerprint," << provenance.ModelFingerprint << "\n"
+              << "catalog_fingerprint," << provenance.CatalogFingerprint << "\n"
+              << "defuzzification," << (provenance.Defuzzification == 0 ? "sampled" : "exact") << "\n"
+              << "sample_count," << provenance.SampleCount << "\n"
+              << "tiles," << raster.getTileCount() << "\n"
+              << "complete_tiles," << raster.countCompleteTiles() << std::endl;
+    return raster.countCompleteTiles() == raster.getTileCount() ? 0 : 2;
+}
+
+int runHazardMap(const FDSHAEngine& engine, const char* faultsPath, const char* gridSpec, std::size_t threads,
+                 const RasterOptions& rasterOptions) {
+    std::vector<Fault> faults;
+    std::vector<std::string> ids;
+    SiteGrid grid;
+    if (!loadFaultCatalog(faultsPath, engine, faults, ids)) return 1;
+    if (gridSpec == nullptr || !parseGridSpec(gridSpec, grid)) {
+        std::cerr << "--hazard-map needs --grid minLat,maxLat,minLon,maxLon,rows,cols" << std::endl;
+        return 1;
+    }
+
+    HazardMapGenerator generator(engine, std::move(faults));
+    if (rasterOptions.Path != nullptr) return writeHazardRaster(generator, grid, rasterOptions, threads);
+    ThreadPool pool(threads);
+    HazardMap map = generator.generate(grid, pool);
+
+    OutputBuffer out(stdout);
+    const char header[] = "lat,lon,PGA,fault\n";
+    out.append(header, sizeof(header) - 1);
+    for (std::size_t row = 0; row < grid.Rows; ++row) {
+        for (std::size_t column = 0; column < grid.Columns; ++column) {
+            std::size_t site = row * grid.Columns + column;
+            out.reserveRow();
+            out.append(grid.latitude(row));
+            out.append(',');
+            out.append(grid.longitude(column));
+            out.append(',');
+            out.append(map.PGA[site]);
+            out.append(',');
+            if (map.ControllingFault[site] != NO_FAULT) {
+                const std::string& id = ids[static_cast<std::size_t>(map.ControllingFault[site])];
+                out.append(id.data(), id.size());
+            }
+            out.append('\n');
+        }
+    }
+    return finishOutput(out, 0);
+}
+
+// --- Monte Carlo Mode ---
+// Distribution spec: "normal:MEAN,SD", "truncnormal:MEAN,SD,LOWER,UPPER", "uniform:LOWER,UPPER" or a plain value
+bool parseDistribution(const char* spec, InputDistribution& distribution) {
+    const char* colon = std::strchr(spec, ':');
+    std::string kind = colon != nullptr ? std::string(spec, colon) : "constant";
+    const char* p = colon != nullptr ? colon + 1 : spec;
+    const char* end = spec + std::strlen(spec);
+
+    std::size_t expected = kind == "normal" ? 2 : kind == "truncnormal" ? 4 : kind == "uniform" ? 2 : kind == "constant" ? 1 : 0;
+    if (expected == 0) return false;
+    double values[4];
+    for (std::size_t i = 0; i < expected; ++i) {
+        p = parseField(i == 0 ? p : p + 1, end, values[i]);
+        if (p == nullptr || (i + 1 < expected && p == end)) return false;
+    }
+    if (p != end) return false;
+
+    try {
+        if (kind == "normal") distribution = InputDistribution::normal(values[0], values[1]);
+        else if (kind == "truncnormal") distribution = InputDistribution::truncatedNormal(values[0], values[1], values[2], values[3]);
+        else if (kind == "uniform") distribution = InputDistribution::uniform(values[0], values[1]);
+        else distribution = InputDistribution::constant(values[0]);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int runMonteCarlo(const FDSHAEngine& engine, std::size_t samples, std::uint64_t seed, std::size_t threads,
+                  const char* mmaxSpec, const char* rSpec, const char* fSpec) {
+    InputDistribution distributions[3];
+    const char* specs[3] = {mmaxSpec, rSpec, fSpec};
+    const char* options[3] = {"--mmax", "--distance", "--fault-type"};
+    for (int i = 0; i < 3; ++i) {
+        if (specs[i] == nullptr || !parseDistribution(specs[i], distributions[i])) {
+            std::cerr << "--monte-carlo needs " << options[i]
+                      << " normal:MEAN,SD | truncnormal:MEAN,SD,LOWER,UPPER | uniform:LOWER,UPPER | VALUE" << std::endl;
+            return 1;
+        }
+    }
+    if (samples == 0) {
+        std::cerr << "--monte-carlo needs a positive sample count" << std::endl;
+        return 1;
+    }
+
+    MonteCarloSettings settings;
+    settings.Samples = samples;
+    settings.Seed = seed;
+    ThreadPool pool(threads);
+    MonteCarloSimulator simulator(engine, distributions[0], distributions[1], distributions[2]);
+    MonteCarloSummary summary;
+    try {
+        summary = simulator.run(settings, pool);
+    } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    if (summary.Rejected > 0) {
+        Universe m = engine.getMagnitudeUniverse(), r = engine.getDistanceUniverse(), f = engine.getFaultTypeUniverse();
+        std::fprintf(stderr,
+                     "Warning: %zu of %zu samples had inputs outside the model's universes (Mmax %zu, R %zu, F %zu) and were "
+                     "excluded; truncate the distributions to Mmax (%g, %g), R (%g, %g), F (%g, %g)\n",
+                     summary.Rejected, summary.Samples, summary.OutOfUniverse[0], summary.OutOfUniverse[1],
+                     summary.OutOfUniverse[2], m.Min, m.Max, r.Min, r.Max, f.Min, f.Max);
+    }
+
+    OutputBuffer out(stdout);
+    auto row = [&](const std::string& name, double value) {
+        out.reserveRow();
+        out.append(name.data(), name.size());
+        out.append(',');
+        out.append(value);
+        out.append('\n');
+    };
+    const char header[] = "statistic,value\n";
+    out.append(header, sizeof(header) - 1);
+    std::string countRows = "samples," + std::to_string(summary.Samples) + "\n"
+                          + "rejected," + std::to_string(summary.Rejected) + "\n";
+    out.append(countRows.data(), countRows.size());
+    row("mean", summary.Mean);
+    row("stddev", summary.StdDev);
+    row("min", summary.Min);
+    row("max", summary.Max);
+    for (std::size_t i = 0; i < settings.Percentiles.size(); ++i) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "p%g", settings.Percentiles[i]);
+        row(name, summary.Percentiles[i]);
+    }
+    for (std::size_t t = 0; t < PGA_VERDICT_THRESHOLDS.size(); ++t) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "P(PGA>=%g)", PGA_VERDICT_THRESHOLDS[t]);
+        row(name, summary.Exceedance[t]);
+    }
+    return finishOutput(out, 0);
+}
+
+// --- Precision Report ---
+// Deviation of the float and fixed-point engines from the double engine over the input domain
+template <typename Scalar>
+void writePrecisionRow(OutputBuffer& out, const char* name, const FDSHAEngine& reference, const FuzzyModel& model,
+                       std::size_t pointsPerAxis) {
+    PrecisionReport report = measurePrecision(reference, PrecisionEngine<Scalar>(model, reference.getSampleCount()), pointsPerAxis);
+    out.reserveRow();
+    out.append(name, std::strlen(name));
+    std::string sizes = "," + std::to_string(sizeof(Scalar)) + "," + std::to_string(report.TableBytes) + ","
+                      + std::to_string(report.Points) + ",";
+    out.append(sizes.data(), sizes.size());
+    const double values[] = {report.MaxDeviation, report.MeanDeviation, report.WorstMmax, report.WorstR, report.WorstF};
+    for (std::size_t i = 0; i < 5; ++i) {
+        out.append(values[i]);
+        out.append(i + 1 < 5 ? ',' : '\n');
+    }
+}
+
+int runPrecisionReport(const FuzzyModel& model, const FDSHAEngine& engine, std::size_t pointsPerAxis) {
+    if (pointsPerAxis < 2) {
+        std::cerr << "--precision-report needs at least 2 points per axis" << std::endl;
+        return 1;
+    }
+    // The reduced-precision engines implement the sampled COG, so that is the reference
+    FDSHAEngine reference = engine;
+    reference.setDefuzzificationMethod(DefuzzificationMethod::SampledCenterOfGravity);
+
+    OutputBuffer out(stdout);
+    const char header[] = "precision,bytes_per_value,table_bytes,points,max_deviation,mean_deviation,worst_mmax,worst_r,worst_f\n";
+    out.append(header, sizeof(header) - 1);
+    writePrecisionRow<double>(out, "double", reference, model, pointsPerAxis);
+    writePrecisionRow<float>(out, "float", reference, model, pointsPerAxis);
+    writePrecisionRow<Fixed32>(out, "fixed32", reference, model, pointsPerAxis);
+    return finishOutput(out, 0);
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--exact] [--model FILE] [--batch [FILE] | --hazard-map FAULTS --grid SPEC\n"
+              << "       | --monte-carlo N --mmax DIST --distance DIST --fault-type DIST [--seed S]] [--threads N]\n"
+              << "  (no options)     interactive prompt\n"
+              << "  --batch [FILE]   score CSV rows 'Mmax,R,F[,id]' from FILE or stdin ('-')\n"
+              << "                   and write 'id,PGA,verdict' rows to stdout\n"
+              << "  --cache [M,R,F]  with --batch, memoize PGA on inputs rounded to these resolutions\n"
+              << "                   (default 0.01,0.01,0.001; 0 keys on the exact value) and report\n"
+              << "                   hit/miss counts on stderr; --cache-entries N bounds the table\n"
+              << "  --surface build|load FILE  with --batch, score rows by trilinear interpolation in a\n"
+              << "                   PGA table: 'build' tabulates the model and writes FILE, 'load' maps\n"
+              << "                   a FILE built from the same model and defuzzifier; --surface-points\n"
+              << "                   M,R,F sets the grid (default 81,201,41)\n"
+              << "  --hazard-map FAULTS  per-site max PGA over a 'lat,lon,Mmax,F[,id]' fault catalog,\n"
+              << "                   written as 'lat,lon,PGA,fault' rows to stdout\n"
+              << "  --grid SPEC      site grid 'minLat,maxLat,minLon,maxLon,rows,cols'\n"
+              << "  --raster FILE    write the hazard map as a tiled binary raster instead of CSV;\n"
+              << "                   a matching FILE left by an interrupted run is resumed. Tune with\n"
+              << "                   --tile-size N (default 256) and --pga-only (no fault layer)\n"
+              << "  --raster-info FILE  print the geometry, provenance and progress of a raster\n"
+              << "  --monte-carlo N  propagate input uncertainty through N samples and write PGA\n"
+              << "                   statistics; needs --mmax, --distance and --fault-type DIST, where\n"
+              << "                   DIST is normal:MEAN,SD | truncnormal:MEAN,SD,LOWER,UPPER |\n"
+              << "                   uniform:LOWER,UPPER | VALUE\n"
+              << "  --seed S         random seed for --monte-carlo (default 0)\n"
+              << "  --serve ADDRESS  answer binary PGA requests on ADDRESS (unix:PATH, tcp:PORT or\n"
+              << "                   tcp:HOST:PORT) until SIGINT/SIGTERM; SIGHUP reloads --model\n"
+              << "  --loadgen ADDRESS  drive a --serve process and report throughput and latency;\n"
+              << "                   tune with --connections N, --rows N (per request), --in-flight N\n"
+              << "                   (per connection) and --duration SECONDS\n"
+              << "  --threads N      worker threads for --hazard-map, --monte-carlo and --serve\n"
+              << "                   (default: all cores)\n"
+              << "  --exact          use the exact center-of-gravity defuzzifier\n"
+              << "  --model FILE     load the rule base and fuzzy sets from FILE instead of the built-in\n"
+              << "                   model; with --batch, SIGHUP re-reads FILE without stopping\n"
+              << "  --write-model FILE  write the model in use to FILE (a template for recalibration)\n"
+              << "  --precision-report [N]  max/mean deviation of the float and fixed-point engines\n"
+              << "                   from the double engine on an N^3 input grid (default 64)\n"
+              << "  --stats FORMAT   write engine statistics ('json' or 'prometheus') to stderr on exit;\n"
+              << "                   with --batch also on SIGUSR1 (needs -DFDSHA_ENABLE_INSTRUMENTATION)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+
+    bool batchMode = false;
+    bool exact = false;
+    const char* modelPath = nullptr;
+    const char* writeModelPath = nullptr;
+    const char* batchPath = "-";
+    const char* faultsPath = nullptr;
+    const char* gridSpec = nullptr;
+    std::size_t threads = 0;
+    bool monteCarloMode = false;
+    std::size_t monteCarloSamples = 0;
+    std::uint64_t seed = 0;
+    const char* distributionSpecs[3] = {nullptr, nullptr, nullptr};
+    const char* statisticsFormat = nullptr;
+    bool precisionReport = false;
+    std::size_t precisionPoints = 64;
+    const char* serveAddress = nullptr;
+    const char* loadAddress = nullptr;
+    LoadSettings load;
+    RasterOptions rasterOptions;
+    const char* rasterInfoPath = nullptr;
+    bool cacheEnabled = false;
+    CacheSettings cacheSettings;
+    bool surfaceEnabled = false;
+    SurfaceOptions surfaceOptions;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--batch") {
+            batchMode = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') batchPath = argv[++i];
+            else if (i + 1 < argc && std::string(argv[i + 1]) == "-") ++i;
+        } else if (arg == "--hazard-map" && i + 1 < argc) {
+            faultsPath = argv[++i];
+        } else if (arg == "--grid" && i + 1 < argc) {
+            gridSpec = argv[++i];
+        } else if (arg == "--raster" && i + 1 < argc) {
+            rasterOptions.Path = argv[++i];
+        } else if (arg == "--tile-size" && i + 1 < argc) {
+            rasterOptions.TileSize = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--pga-only") {
+            rasterOptions.FaultLayer = false;
+        } else if (arg == "--raster-info" && i + 1 < argc) {
+            rasterInfoPath = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--monte-carlo" && i + 1 < argc) {
+            monteCarloMode = true;
+            monteCarloSamples = static_cast<std::size_t>(std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--mmax" && i + 1 < argc) {
+            distributionSpecs[0] = argv[++i];
+        } else if (arg == "--distance" && i + 1 < argc) {
+            distributionSpecs[1] = argv[++i];
+        } else if (arg == "--fault-type" && i + 1 < argc) {
+            distributionSpecs[2] = argv[++i];
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<std::uint64_t>(std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--exact") {
+            exact = true;
+        } else if (arg == "--model" && i + 1 < argc) {
+            modelPath = argv[++i];
+        } else if (arg == "--write-model" && i + 1 < argc) {
+            writeModelPath = argv[++i];
+        } else if (arg == "--serve" && i + 1 < argc) {
+            serveAddress = argv[++i];
+        } else if (arg == "--loadgen" && i + 1 < argc) {
+            loadAddress = argv[++i];
+        } else if (arg == "--connections" && i + 1 < argc) {
+            load.Connections = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--rows" && i + 1 < argc) {
+            load.RowsPerRequest = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--in-flight" && i + 1 < argc) {
+            load.InFlight = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--duration" && i + 1 < argc) {
+            load.Seconds = std::atof(argv[++i]);
+        } else if (arg == "--cache") {
+            cacheEnabled = true;
+            if (i + 1 < argc && (std::isdigit(static_cast<unsigned char>(argv[i + 1][0])) || argv[i + 1][0] == '.')) {
+                char trailing;
+                if (std::sscanf(argv[++i], "%lf,%lf,%lf%c", &cacheSettings.MmaxResolution, &cacheSettings.RResolution,
+                                &cacheSettings.FResolution, &trailing) != 3) {
+                    std::cerr << "--cache expects resolutions 'MMAX,R,F', e.g. 0.1,0.1,0.05" << std::endl;
+                    return 1;
+                }
+            }
+        } else if (arg == "--cache-entries" && i + 1 < argc) {
+            cacheSettings.Capacity = static_cast<std::size_t>(std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--surface" && i + 2 < argc) {
+            std::string mode = argv[++i];
+            if (mode != "build" && mode != "load") {
+                std::cerr << "--surface expects 'build FILE' or 'load FILE'" << std::endl;
+                return 1;
+            }
+            surfaceEnabled = true;
+            surfaceOptions.Load = mode == "load";
+            surfaceOptions.Path = argv[++i];
+        } else if (arg == "--surface-points" && i + 1 < argc) {
+            char trailing;
+            std::size_t* points = surfaceOptions.Points;
+            if (std::sscanf(argv[++i], "%zu,%zu,%zu%c", &points[0], &points[1], &points[2], &trailing) != 3
+                || points[0] < 2 || points[1] < 2 || points[2] < 2) {
+                std::cerr << "--surface-points expects 'MMAX,R,F' counts of at least 2, e.g. 81,201,41" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--precision-report") {
+            precisionReport = true;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                precisionPoints = static_cast<std::size_t>(std::strtoul(argv[++i], nullptr, 10));
+            }
+        } else if (arg == "--stats" && i + 1 < argc
+                   && (std::strcmp(argv[i + 1], "json") == 0 || std::strcmp(argv[i + 1], "prometheus") == 0)) {
+            statisticsFormat = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    if (loadAddress != nullptr) {
+        load.Address = loadAddress;
+        load.Seed = seed;
+        return runLoadGenerator(load);
+    }
+    if (rasterInfoPath != nullptr) return runRasterInfo(rasterInfoPath);
+
+    std::shared_ptr<FDSHAEngine> configured;
+    FuzzyModel model;
+    try {
+        model = modelPath != nullptr ? FuzzyModel::load(modelPath) : FuzzyModel::builtin();
+        configured = std::make_shared<FDSHAEngine>(model);
+        if (writeModelPath != nullptr) {
+            model.save(writeModelPath);
+            return 0;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    if (exact) configured->setDefuzzificationMethod(DefuzzificationMethod::ExactCenterOfGravity);
+    EngineHandle engines(configured);
+    const FDSHAEngine& engine = *configured;
+
+    if (statisticsFormat != nullptr && !INSTRUMENTATION_ENABLED) {
+        std::cerr << "Warning: built without FDSHA_ENABLE_INSTRUMENTATION; --stats reports zeros" << std::endl;
+    }
+    auto finish = [&](int status) {
+        if (statisticsFormat != nullptr) writeStatistics(statisticsFormat);
+        return status;
+    };
+
+    if (serveAddress != nullptr) {
+        ServerSettings settings;
+        settings.Address = serveAddress;
+        settings.Workers = threads;
+        return finish(runServer(engines, modelPath, settings, statisticsFormat));
+    }
+    if (precisionReport) return finish(runPrecisionReport(model, engine, precisionPoints));
+    if (faultsPath != nullptr) return finish(runHazardMap(engine, faultsPath, gridSpec, threads, rasterOptions));
+    if (monteCarloMode) {
+        return finish(runMonteCarlo(engine, monteCarloSamples, seed, threads, distributionSpecs[0], distributionSpecs[1],
+                                    distributionSpecs[2]));
+    }
+
+    if (batchMode) {
+        if (cacheEnabled && surfaceEnabled) {
+            std::cerr << "--cache and --surface cannot be combined" << std::endl;
+            return 1;
+        }
+        std::FILE* in = std::strcmp(batchPath, "-") == 0 ? stdin : std::fopen(batchPath, "rb");
+        if (in == nullptr) {
+            std::cerr << "Cannot open " << batchPath << std::endl;
+            return 1;
+        }
+#ifdef SIGHUP
+        if (modelPath != nullptr) std::signal(SIGHUP, requestReload);
+#endif
+#ifdef SIGUSR1
+        if (statisticsFormat != nullptr) std::signal(SIGUSR1, requestStatistics);
+#endif
+        int status;
+        try {
+            status = runBatch(engines, modelPath, statisticsFormat, cacheEnabled ? &cacheSettings : nullptr,
+                              surfaceEnabled ? &surfaceOptions : nullptr, in);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            status = 1;
+        }
+        if (in != stdin) std::fclose(in);
+        return finish(status);
+    }
 
     std::cout << " Fuzzy Deterministic Seismic Hazard Analysis (FDSHA)  " << std::endl;
-    FDSHAEngine engine;
     char continue_choice;
 
     do {
@@ -84,5 +1036,5 @@ int main() {
     } while (continue_choice == 'y');
 
     std::cout << "\nProgram ended." << std::endl;
-    return 0;
+    return finish(0);
 }
@@ -0,0 +1,156 @@
+// Stress test for sharing one immutable engine between threads.
+//
+// Every thread scores the same inputs through a single const FDSHAEngine (scalar and batch, both
+// defuzzifiers) and must reproduce the single-threaded results bit for bit. A second phase keeps
+// publishing engines through an EngineHandle while readers score on their snapshots; each result
+// must match the engine the reader acquired.
+//
+// Build and run from fdsha_final/ (add -fsanitize=thread to also check for data races):
+//   g++ -std=c++17 -O2 -pthread -I. tests/ConcurrencyTest.cpp $(ls *.cpp | grep -v main.cpp) -o concurrency_test
+//   ./concurrency_test [THREADS]
+
+#include "EngineHandle.h"
+#include "FDSHAEngine.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace FDSHA;
+
+namespace {
+
+    const std::size_t INPUT_COUNT = 2048;
+    const int ROUNDS = 16;
+
+    struct Inputs {
+        std::vector<double> Mmax, R, F;
+        std::size_t size() const { return Mmax.size(); }
+    };
+
+    // Slightly wider than the universes, so out-of-universe fallbacks are exercised too
+    Inputs randomInputs(const FDSHAEngine& engine) {
+        std::mt19937 generator(7);
+        Universe m = engine.getMagnitudeUniverse(), r = engine.getDistanceUniverse(), f = engine.getFaultTypeUniverse();
+        std::uniform_real_distribution<double> mmax(m.Min - 0.2, m.Max + 0.2), distance(r.Min - 5.0, r.Max + 5.0),
+            faultType(f.Min - 0.02, f.Max + 0.02);
+        Inputs inputs;
+        for (std::size_t i = 0; i < INPUT_COUNT; ++i) {
+            inputs.Mmax.push_back(mmax(generator));
+            inputs.R.push_back(distance(generator));
+            inputs.F.push_back(faultType(generator));
+        }
+        return inputs;
+    }
+
+    // Single-threaded reference results of one engine
+    struct Expected {
+        std::vector<double> Scalar, Batch;
+    };
+
+    Expected score(const FDSHAEngine& engine, const Inputs& inputs) {
+        Expected expected{std::vector<double>(inputs.size()), std::vector<double>(inputs.size())};
+        for (std::size_t i = 0; i < inputs.size(); ++i) expected.Scalar[i] = engine.findPGA(inputs.Mmax[i], inputs.R[i], inputs.F[i]);
+        engine.findPGABatch(inputs.Mmax.data(), inputs.R.data(), inputs.F.data(), expected.Batch.data(), inputs.size());
+        return expected;
+    }
+
+    bool same(double a, double b) { return std::memcmp(&a, &b, sizeof(double)) == 0; }
+
+    // Scores every input once, starting at a thread-specific offset so threads hit different
+    // rows at the same moment; returns the number of results that differ from the reference.
+    std::size_t scoreAndCompare(const FDSHAEngine& engine, const Inputs& inputs, const Expected& expected, std::size_t offset,
+                                std::vector<double>& batch) {
+        std::size_t mismatches = 0;
+        std::size_t n = inputs.size();
+        for (std::size_t k = 0; k < n; ++k) {
+            std::size_t i = (k + offset) % n;
+            mismatches += !same(engine.findPGA(inputs.Mmax[i], inputs.R[i], inputs.F[i]), expected.Scalar[i]);
+        }
+        batch.resize(n);
+        engine.findPGABatch(inputs.Mmax.data(), inputs.R.data(), inputs.F.data(), batch.data(), n);
+        for (std::size_t i = 0; i < n; ++i) mismatches += !same(batch[i], expected.Batch[i]);
+        return mismatches;
+    }
+
+    // Phase 1: all threads on one const engine
+    bool stressSharedEngine(const FDSHAEngine& engine, const char* name, const Inputs& inputs, unsigned threads) {
+        const Expected expected = score(engine, inputs);
+        std::atomic<std::size_t> mismatches{0};
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                std::vector<double> batch;
+                for (int round = 0; round < ROUNDS; ++round) {
+                    mismatches += scoreAndCompare(engine, inputs, expected, (t * 997 + round * 131) % inputs.size(), batch);
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+
+        std::printf("%-8s %u threads x %d rounds: %zu mismatches\n", name, threads, ROUNDS, mismatches.load());
+        return mismatches.load() == 0;
+    }
+
+    // Phase 2: readers on EngineHandle snapshots while a publisher alternates two engines
+    bool stressEngineHandle(const std::shared_ptr<const FDSHAEngine> engines[2], const Inputs& inputs, unsigned threads) {
+        const Expected expected[2] = {score(*engines[0], inputs), score(*engines[1], inputs)};
+        EngineHandle handle(engines[0]);
+        std::atomic<bool> done{false};
+        std::atomic<std::size_t> mismatches{0}, publications{0};
+
+        std::thread publisher([&] {
+            for (std::size_t i = 1; !done.load(); ++i) {
+                handle.publish(engines[i % 2]);
+                ++publications;
+                std::this_thread::yield();
+            }
+        });
+        std::vector<std::thread> readers;
+        for (unsigned t = 0; t < threads; ++t) {
+            readers.emplace_back([&, t] {
+                std::vector<double> batch;
+                for (int round = 0; round < ROUNDS; ++round) {
+                    std::shared_ptr<const FDSHAEngine> snapshot = handle.acquire();
+                    const Expected& reference = expected[snapshot == engines[0] ? 0 : 1];
+                    mismatches += scoreAndCompare(*snapshot, inputs, reference, (t * 997 + round * 131) % inputs.size(), batch);
+                }
+            });
+        }
+        for (auto& reader : readers) reader.join();
+        done = true;
+        publisher.join();
+
+        std::printf("handle   %u readers x %d rounds, %zu publications: %zu mismatches\n", threads, ROUNDS, publications.load(),
+                    mismatches.load());
+        return mismatches.load() == 0;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // At least four threads, so the test interleaves even on small machines
+    unsigned threads = argc > 1 ? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10))
+                                : std::max(4u, std::thread::hardware_concurrency());
+    if (threads == 0) {
+        std::fprintf(stderr, "Usage: %s [THREADS]\n", argv[0]);
+        return 2;
+    }
+
+    auto sampled = std::make_shared<FDSHAEngine>();
+    auto exact = std::make_shared<FDSHAEngine>();
+    exact->setDefuzzificationMethod(DefuzzificationMethod::ExactCenterOfGravity);
+    const Inputs inputs = randomInputs(*sampled);
+
+    bool passed = stressSharedEngine(*sampled, "sampled", inputs, threads);
+    passed &= stressSharedEngine(*exact, "exact", inputs, threads);
+    const std::shared_ptr<const FDSHAEngine> engines[2] = {sampled, exact};
+    passed &= stressEngineHandle(engines, inputs, threads);
+    if (!passed) std::fprintf(stderr, "FAIL concurrent results differ from the single-threaded reference\n");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+// Convergence test for the exact center-of-gravity defuzzifier.
+//
+// The sampled COG is a discretization of the integral the exact COG evaluates in closed form,
+// so over a fixed set of inputs its largest deviation from the exact COG must shrink at least
+// MIN_REDUCTION-fold each time the sample count grows tenfold (the sum converges at first order),
+// and vanish at fine sampling.
+//
+// Build and run from fdsha_final/:
+//   g++ -std=c++17 -O2 -pthread -I. tests/DefuzzifierConvergenceTest.cpp $(ls *.cpp | grep -v main.cpp) -o convergence_test
+//   ./convergence_test
+
+#include "FDSHAEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace FDSHA;
+
+namespace {
+
+    const int SAMPLE_COUNTS[] = {10, 100, 1000, 10000, 100000};
+    const double MIN_REDUCTION = 5.0;
+
+    // Largest deviation allowed at the finest sampling, in g
+    const double FINEST_TOLERANCE = 1e-5;
+
+} // namespace
+
+int main() {
+    FDSHAEngine exact;
+    exact.setDefuzzificationMethod(DefuzzificationMethod::ExactCenterOfGravity);
+
+    // Inputs inside the universes, so nearly all of them fire rules
+    std::mt19937 generator(20240611);
+    Universe m = exact.getMagnitudeUniverse(), r = exact.getDistanceUniverse(), f = exact.getFaultTypeUniverse();
+    std::uniform_real_distribution<double> mmax(m.Min, m.Max), distance(r.Min, r.Max), faultType(f.Min, f.Max);
+    std::vector<double> inputs;
+    for (int i = 0; i < 2000; ++i) {
+        inputs.push_back(mmax(generator));
+        inputs.push_back(distance(generator));
+        inputs.push_back(faultType(generator));
+    }
+    std::vector<double> reference;
+    for (std::size_t i = 0; i < inputs.size(); i += 3) reference.push_back(exact.findPGA(inputs[i], inputs[i + 1], inputs[i + 2]));
+
+    bool passed = true;
+    double previous = INFINITY;
+    for (int count : SAMPLE_COUNTS) {
+        FDSHAEngine sampled;
+        sampled.setSampleCount(count);
+        double maxError = 0.0;
+        for (std::size_t i = 0; i < inputs.size(); i += 3) {
+            double pga = sampled.findPGA(inputs[i], inputs[i + 1], inputs[i + 2]);
+            maxError = std::max(maxError, std::fabs(pga - reference[i / 3]));
+        }
+        std::printf("samples %6d  max |sampled - exact| = %.3e g\n", count, maxError);
+        if (!(maxError * MIN_REDUCTION <= previous)) {
+            std::fprintf(stderr, "FAIL error did not shrink %.0fx from %.3e at %d samples\n", MIN_REDUCTION, previous, count);
+            passed = false;
+        }
+        previous = maxError;
+    }
+    if (!(previous <= FINEST_TOLERANCE)) {
+        std::fprintf(stderr, "FAIL error %.3e at the finest sampling exceeds %.0e g\n", previous, FINEST_TOLERANCE);
+        passed = false;
+    }
+    return passed ? 0 : 1;
+}
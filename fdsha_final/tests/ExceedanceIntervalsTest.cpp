@@ -0,0 +1,150 @@
+// Brute-force test for the inverse exceedance query.
+//
+// For random queries with covered fixed inputs, every covered point of a dense sweep of the varied
+// axis must lie inside a reported interval exactly when its PGA reaches the threshold. Points
+// within EDGE_SLACK of an interval end are skipped, since ends are only resolved to the tolerance.
+// A batch call must match the single queries interval for interval and evaluation for evaluation.
+// With uncovered fixed inputs every point gets the empty-set fallback, so a threshold at the
+// fallback returns the whole universe.
+//
+// Build and run from fdsha_final/:
+//   g++ -std=c++17 -O2 -pthread -I. tests/ExceedanceIntervalsTest.cpp $(ls *.cpp | grep -v main.cpp) -o exceedance_test
+//   ./exceedance_test
+
+#include "FDSHAEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace FDSHA;
+
+namespace {
+
+    const int QUERIES = 1200;
+    const std::size_t SWEEP_POINTS = 4001;
+    const double EDGE_SLACK = 1e-6;
+
+    Universe universeOf(const FDSHAEngine& engine, InputAxis axis) {
+        switch (axis) {
+        case InputAxis::Magnitude: return engine.getMagnitudeUniverse();
+        case InputAxis::Distance: return engine.getDistanceUniverse();
+        case InputAxis::FaultType:
+        default: return engine.getFaultTypeUniverse();
+        }
+    }
+
+    // Random value strictly inside the universe, where the built-in model's sets cover the axis
+    double interior(const Universe& universe, std::mt19937& generator) {
+        double margin = 1e-3 * (universe.Max - universe.Min);
+        return std::uniform_real_distribution<double>(universe.Min + margin, universe.Max - margin)(generator);
+    }
+
+    bool inside(const ExceedanceIntervals& result, double x, bool& nearEdge) {
+        nearEdge = false;
+        bool found = false;
+        for (const Universe& interval : result.Intervals) {
+            if (std::fabs(x - interval.Min) <= EDGE_SLACK || std::fabs(x - interval.Max) <= EDGE_SLACK) nearEdge = true;
+            if (x >= interval.Min && x <= interval.Max) found = true;
+        }
+        return found;
+    }
+
+    struct Query {
+        InputAxis Axis;
+        double Threshold;
+        double Inputs[3]; // Mmax, R, F
+    };
+
+    // Classifies every sweep point of one query; returns the number of misclassified points
+    std::size_t checkQuery(const FDSHAEngine& engine, const Query& query, const ExceedanceIntervals& result) {
+        Universe range = universeOf(engine, query.Axis);
+        std::size_t varied = static_cast<std::size_t>(query.Axis);
+        std::vector<double> inputs[3];
+        for (std::size_t v = 0; v < 3; ++v) inputs[v].assign(SWEEP_POINTS, query.Inputs[v]);
+        for (std::size_t i = 0; i < SWEEP_POINTS; ++i) {
+            inputs[varied][i] = range.Min + (range.Max - range.Min) * static_cast<double>(i) / static_cast<double>(SWEEP_POINTS - 1);
+        }
+        std::vector<double> pga(SWEEP_POINTS);
+        engine.findPGABatch(inputs[0].data(), inputs[1].data(), inputs[2].data(), pga.data(), SWEEP_POINTS);
+
+        std::size_t wrong = 0;
+        for (std::size_t i = 0; i < SWEEP_POINTS; ++i) {
+            // The universe ends fire no rule and get the fallback, which the query does not report
+            if (!engine.isCovered(query.Axis, inputs[varied][i])) continue;
+            bool nearEdge;
+            bool reported = inside(result, inputs[varied][i], nearEdge);
+            if (!nearEdge && reported != (pga[i] >= query.Threshold)) ++wrong;
+        }
+        return wrong;
+    }
+
+    bool sameResult(const ExceedanceIntervals& a, const ExceedanceIntervals& b) {
+        if (a.Evaluations != b.Evaluations || a.Intervals.size() != b.Intervals.size()) return false;
+        for (std::size_t i = 0; i < a.Intervals.size(); ++i) {
+            if (a.Intervals[i].Min != b.Intervals[i].Min || a.Intervals[i].Max != b.Intervals[i].Max) return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main() {
+    FDSHAEngine engine;
+    std::mt19937 generator(1337);
+    const InputAxis axes[3] = {InputAxis::Magnitude, InputAxis::Distance, InputAxis::FaultType};
+    std::uniform_real_distribution<double> threshold(0.05, 0.85);
+
+    std::vector<Query> queries;
+    for (int q = 0; q < QUERIES; ++q) {
+        Query query{axes[q % 3], threshold(generator), {}};
+        for (std::size_t v = 0; v < 3; ++v) query.Inputs[v] = interior(universeOf(engine, axes[v]), generator);
+        queries.push_back(query);
+    }
+
+    bool passed = true;
+    std::size_t wrongPoints = 0, wrongQueries = 0, batchMismatches = 0, intervals = 0;
+    for (const Query& query : queries) {
+        ExceedanceIntervals single = engine.findExceedanceIntervals(query.Axis, query.Threshold, query.Inputs[0], query.Inputs[1],
+                                                                    query.Inputs[2]);
+        std::size_t wrong = checkQuery(engine, query, single);
+        wrongPoints += wrong;
+        wrongQueries += wrong > 0;
+        intervals += single.Intervals.size();
+    }
+
+    // All queries in one batch call, varying R at one threshold
+    const double BATCH_THRESHOLD = 0.3;
+    std::vector<double> mmax, r, f;
+    for (const Query& query : queries) {
+        mmax.push_back(query.Inputs[0]);
+        r.push_back(query.Inputs[1]);
+        f.push_back(query.Inputs[2]);
+    }
+    std::vector<ExceedanceIntervals> batch(queries.size());
+    engine.findExceedanceIntervalsBatch(InputAxis::Distance, BATCH_THRESHOLD, mmax.data(), nullptr, f.data(), batch.data(),
+                                        batch.size());
+    for (std::size_t q = 0; q < queries.size(); ++q) {
+        ExceedanceIntervals single = engine.findExceedanceIntervals(InputAxis::Distance, BATCH_THRESHOLD, mmax[q], 0.0, f[q]);
+        batchMismatches += !sameResult(single, batch[q]);
+    }
+
+    std::printf("%d queries x %zu sweep points: %zu intervals, %zu misclassified points in %zu queries, %zu batch mismatches\n",
+                QUERIES, SWEEP_POINTS, intervals, wrongPoints, wrongQueries, batchMismatches);
+    passed &= wrongPoints == 0 && batchMismatches == 0;
+
+    // Beyond the distance horizon no rule fires for any Mmax: the fallback exceeds a low threshold everywhere
+    Universe magnitudes = engine.getMagnitudeUniverse();
+    double horizon = engine.getDistanceHorizon();
+    double fallback = engine.findPGA(7.0, horizon + 50.0, 0.0);
+    ExceedanceIntervals uncovered = engine.findExceedanceIntervals(InputAxis::Magnitude, fallback, 0.0, horizon + 50.0, 0.0);
+    bool whole = uncovered.Intervals.size() == 1 && uncovered.Intervals[0].Min == magnitudes.Min &&
+                 uncovered.Intervals[0].Max == magnitudes.Max;
+    std::printf("uncovered R = %g km, threshold %g g: %zu intervals\n", horizon + 50.0, fallback, uncovered.Intervals.size());
+    if (!whole) std::fprintf(stderr, "FAIL uncovered fixed inputs did not return the whole universe\n");
+    passed &= whole;
+
+    if (wrongPoints != 0 || batchMismatches != 0) std::fprintf(stderr, "FAIL intervals disagree with the sweep or the batch call\n");
+    return passed ? 0 : 1;
+}
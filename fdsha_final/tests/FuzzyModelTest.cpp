@@ -0,0 +1,166 @@
+// Test for the model text format and its validation.
+//
+// The built-in model must survive write -> parse with the same fingerprint, the same text and an
+// engine that scores bit for bit like the built-in one. Every rejection rule of parse() and
+// validate() is then triggered by a one-line edit of that text and must throw the documented
+// exception type with a message naming the problem (and, for parse errors, the line).
+//
+// Build and run from fdsha_final/:
+//   g++ -std=c++17 -O2 -pthread -I. tests/FuzzyModelTest.cpp $(ls *.cpp | grep -v main.cpp) -o model_test
+//   ./model_test
+
+#include "FDSHAEngine.h"
+#include "FuzzyModel.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace FDSHA;
+
+namespace {
+
+    std::string toText(const FuzzyModel& model) {
+        std::ostringstream out;
+        model.write(out);
+        return out.str();
+    }
+
+    FuzzyModel fromText(const std::string& text) {
+        std::istringstream in(text);
+        return FuzzyModel::parse(in, "model");
+    }
+
+    // The text with one whole line replaced (an empty replacement removes it)
+    std::string edit(const std::string& text, const std::string& line, const std::string& replacement) {
+        std::size_t at = text.find(line + "\n");
+        if (at == std::string::npos) {
+            std::fprintf(stderr, "test bug: no line '%s'\n", line.c_str());
+            return text;
+        }
+        return text.substr(0, at) + (replacement.empty() ? "" : replacement + "\n") + text.substr(at + line.size() + 1);
+    }
+
+    struct Rejection {
+        const char* What;
+        std::string Text;
+        const char* Message; // expected substring of the exception message
+    };
+
+    // Parses and validates text; true if it throws Exception with the expected message
+    template <typename Exception>
+    bool rejects(const Rejection& rejection) {
+        try {
+            fromText(rejection.Text).validate();
+        } catch (const Exception& e) {
+            bool named = std::strstr(e.what(), rejection.Message) != nullptr;
+            if (!named) std::fprintf(stderr, "FAIL %s: message '%s' lacks '%s'\n", rejection.What, e.what(), rejection.Message);
+            return named;
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "FAIL %s: wrong exception type: %s\n", rejection.What, e.what());
+            return false;
+        }
+        std::fprintf(stderr, "FAIL %s: accepted\n", rejection.What);
+        return false;
+    }
+
+    bool sameScores(const FDSHAEngine& a, const FDSHAEngine& b) {
+        for (double mmax = 4.0; mmax <= 9.0; mmax += 0.0625) {
+            for (double r = -5.0; r <= 210.0; r += 2.5) {
+                for (double f = -0.125; f <= 0.125; f += 0.015625) {
+                    double x = a.findPGA(mmax, r, f), y = b.findPGA(mmax, r, f);
+                    if (std::memcmp(&x, &y, sizeof(double)) != 0) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+} // namespace
+
+int main() {
+    bool passed = true;
+
+    // 1. Round trip
+    const FuzzyModel builtin = FuzzyModel::builtin();
+    const std::string text = toText(builtin);
+    FuzzyModel parsed = fromText(text);
+    parsed.validate();
+    bool sameFingerprint = parsed.fingerprint() == builtin.fingerprint();
+    bool sameText = toText(parsed) == text;
+    FuzzyModel reordered = parsed;
+    std::reverse(reordered.Rules.begin(), reordered.Rules.end());
+    bool orderFree = reordered.fingerprint() == builtin.fingerprint();
+    FDSHAEngine fromFile(parsed);
+    bool sameEngine = fromFile.getModelFingerprint() == FDSHAEngine().getModelFingerprint() && sameScores(fromFile, FDSHAEngine());
+    std::printf("round trip: fingerprint %s, text %s, rule order %s, engine %s\n", sameFingerprint ? "same" : "DIFFERENT",
+                sameText ? "same" : "DIFFERENT", orderFree ? "ignored" : "MATTERS", sameEngine ? "same" : "DIFFERENT");
+    if (!(sameFingerprint && sameText && orderFree && sameEngine)) {
+        std::fprintf(stderr, "FAIL the built-in model does not round-trip\n");
+        passed = false;
+    }
+
+    // A recalibrated breakpoint changes the fingerprint
+    FuzzyModel moved = fromText(edit(text, "set R Far triangular 60 100 140", "set R Far triangular 60 101 140"));
+    moved.validate();
+    if (moved.fingerprint() == builtin.fingerprint()) {
+        std::fprintf(stderr, "FAIL moving a breakpoint kept the fingerprint\n");
+        passed = false;
+    }
+
+    // 2. Parse errors (std::runtime_error naming the line)
+    const std::string firstRule = "rule Short Near Normal Low";
+    const std::vector<Rejection> parseErrors = {
+        {"empty file", "# nothing\n", "empty model file"},
+        {"missing header", edit(text, "fdsha-model 1", ""), "model:2: expected 'fdsha-model 1' header"},
+        {"wrong version", edit(text, "fdsha-model 1", "fdsha-model 2"), "model:1: expected 'fdsha-model 1' header"},
+        {"unknown keyword", edit(text, "universe R 0 200", "range R 0 200"), "model:10: unknown keyword 'range'"},
+        {"short universe", edit(text, "universe R 0 200", "universe R 0"), "expected 'universe VARIABLE MIN MAX'"},
+        {"unknown variable", edit(text, "universe R 0 200", "universe Depth 0 200"), "unknown variable 'Depth'"},
+        {"universe twice", edit(text, "universe R 0 200", "universe R 0 200\nuniverse R 0 200"), "universe of R defined twice"},
+        {"missing universe", edit(text, "universe R 0 200", ""), "missing universe of R"},
+        {"not a number", edit(text, "universe R 0 200", "universe R 0 200km"), "'200km' is not a number"},
+        {"unknown term", edit(text, "set R Far triangular 60 100 140", "set R Distant triangular 60 100 140"),
+         "unknown R term 'Distant'"},
+        {"set twice", edit(text, "set R Far triangular 60 100 140", "set R Far triangular 60 100 140\nset R Far triangular 60 100 140"),
+         "R Far defined twice"},
+        {"missing set", edit(text, "set R Far triangular 60 100 140", ""), "missing set R Far"},
+        {"short set", edit(text, "set R Far triangular 60 100 140", "set R"), "expected 'set VARIABLE TERM"},
+        {"wrong breakpoint count", edit(text, "set R Far triangular 60 100 140", "set R Far triangular 60 100"),
+         "expected 'triangular A B C' or 'trapezoidal A B C D'"},
+        {"unknown shape", edit(text, "set R Far triangular 60 100 140", "set R Far gaussian 100 20 0"),
+         "expected 'triangular A B C' or 'trapezoidal A B C D'"},
+        {"short rule", edit(text, firstRule, "rule Short Near Normal"), "expected 'rule MMAX R F PGA'"},
+        {"unknown consequent", edit(text, firstRule, "rule Short Near Normal Huge"), "unknown PGA term 'Huge'"},
+    };
+    std::size_t parseFailures = 0;
+    for (const Rejection& rejection : parseErrors) parseFailures += !rejects<std::runtime_error>(rejection);
+
+    // 3. Validation errors (std::invalid_argument)
+    const std::vector<Rejection> validationErrors = {
+        {"empty universe", edit(text, "universe F -0.1 0.1", "universe F 0.1 0.1"), "F universe must be a finite, non-empty interval"},
+        {"infinite universe", edit(text, "universe PGA 0 0.9", "universe PGA 0 inf"), "PGA universe must be a finite"},
+        {"unordered breakpoints", edit(text, "set R Far triangular 60 100 140", "set R Far triangular 100 60 140"),
+         "R Far needs breakpoints a <= b <= c <= d"},
+        {"outside universe", edit(text, "set R VeryFar trapezoidal 120 160 200 200", "set R VeryFar trapezoidal 120 160 200 210"),
+         "R VeryFar extends outside the universe"},
+        {"terms out of order", edit(text, "set R Far triangular 60 100 140", "set R Far triangular 10 30 50"),
+         "R Far is out of order with Medium"},
+        {"gap", edit(text, "set R Far triangular 60 100 140", "set R Far triangular 80 100 140"), "R has a gap between Medium and Far"},
+        {"uncovered universe", edit(text, "set R Near trapezoidal 0 0 20 40", "set R Near trapezoidal 5 5 20 40"),
+         "R sets do not cover the universe"},
+        {"duplicate rule", edit(text, firstRule, firstRule + "\n" + firstRule), "duplicate rule for (Short, Near, Normal)"},
+        {"missing rule", edit(text, firstRule, ""), "no rule for (Short, Near, Normal)"},
+    };
+    std::size_t validationFailures = 0;
+    for (const Rejection& rejection : validationErrors) validationFailures += !rejects<std::invalid_argument>(rejection);
+
+    std::printf("parse errors: %zu of %zu rejected as expected\n", parseErrors.size() - parseFailures, parseErrors.size());
+    std::printf("validation errors: %zu of %zu rejected as expected\n", validationErrors.size() - validationFailures,
+                validationErrors.size());
+    passed &= parseFailures == 0 && validationFailures == 0;
+    return passed ? 0 : 1;
+}
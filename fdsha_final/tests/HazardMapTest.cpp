@@ -0,0 +1,63 @@
+// Hazard-map test for faults and sites where the engine has no rule to fire.
+//
+// A fault whose Mmax lies on a universe end fires no rule, so scoring it would only yield the
+// defuzzifier's empty-set fallback; it must never control a site. A site on top of an epicentre
+// (R = 0, where the distance sets are zero) must get the near-field PGA, not the fallback.
+//
+// Build and run from fdsha_final/:
+//   g++ -std=c++17 -O2 -pthread -I. tests/HazardMapTest.cpp $(ls *.cpp | grep -v main.cpp) -o hazard_map_test
+//   ./hazard_map_test
+
+#include "FDSHAEngine.h"
+#include "HazardMap.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace FDSHA;
+
+namespace {
+
+    // Catalog indices
+    const std::int32_t LARGE_FAULT = 0;    // M7.0 at 37, 54
+    const std::int32_t BOUNDARY_FAULT = 1; // M4.5 at 37.5, 54.5: Mmax on the universe minimum
+
+    bool check(bool condition, const char* what) {
+        if (!condition) std::fprintf(stderr, "FAIL %s\n", what);
+        return condition;
+    }
+
+} // namespace
+
+int main() {
+    FDSHAEngine engine;
+    std::vector<Fault> faults = {{37.0, 54.0, 7.0, 0.0}, {37.5, 54.5, 4.5, 0.0}};
+    bool passed = check(!engine.isCovered(InputAxis::Magnitude, 4.5), "Mmax 4.5 is expected to be uncovered");
+    passed &= check(!engine.isCovered(InputAxis::Distance, 0.0), "R = 0 is expected to be uncovered");
+
+    // 2 x 2 sites: (37, 54) on the large fault, (37.5, 54.5) on the boundary fault
+    SiteGrid grid{37.0, 54.0, 0.5, 0.5, 2, 2};
+    HazardMapGenerator generator(engine, faults);
+    ThreadPool pool(2);
+    HazardMap map = generator.generate(grid, pool);
+
+    // The near-field limit of the large fault; the batch kernel agrees within BATCH_TOLERANCE
+    double nearField = engine.findPGA(7.0, 1e-9, 0.0);
+    double onFault = map.PGA[0];
+    std::printf("site on the M7.0 fault: %.6f g (near field %.6f g), fault %d\n", onFault, nearField, map.ControllingFault[0]);
+    passed &= check(map.ControllingFault[0] == LARGE_FAULT, "the site on the M7.0 fault is not controlled by it");
+    passed &= check(std::fabs(onFault - nearField) <= BATCH_TOLERANCE, "the site on the M7.0 fault does not get its near-field PGA");
+
+    for (std::size_t site = 0; site < grid.size(); ++site) {
+        std::printf("site %zu: %.6f g, fault %d\n", site, map.PGA[site], map.ControllingFault[site]);
+        passed &= check(map.ControllingFault[site] != BOUNDARY_FAULT, "the M4.5 boundary fault controls a site");
+    }
+
+    // Only the boundary fault is near: the site gets nothing rather than the fallback
+    HazardMapGenerator boundaryOnly(engine, {faults[BOUNDARY_FAULT]});
+    HazardMap empty = boundaryOnly.generate(SiteGrid{37.5, 54.5, 0.0, 0.0, 1, 1}, pool);
+    passed &= check(empty.PGA[0] == 0.0 && empty.ControllingFault[0] == NO_FAULT,
+                    "a site near only an uncovered fault is not empty");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+// Resume and refusal test for tiled hazard rasters.
+//
+// A run is interrupted after half of its tiles reached a checkpoint, with stale values left in
+// tiles that did not. Resuming must recompute exactly the unflagged tiles, and the finished file
+// must match an in-memory hazard map bit for bit. A file with another provenance or grid, a
+// foreign file that merely starts with zero bytes, and a truncated raster must be refused and left
+// untouched; only a zeroed file of the raster's exact size (killed before its header was written)
+// is started over.
+//
+// Build and run from fdsha_final/:
+//   g++ -std=c++17 -O2 -pthread -I. tests/HazardRasterTest.cpp $(ls *.cpp | grep -v main.cpp) -o hazard_raster_test
+//   ./hazard_raster_test
+
+#include "FDSHAEngine.h"
+#include "HazardMap.h"
+#include "HazardRaster.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace FDSHA;
+
+namespace {
+
+    const char* RASTER_PATH = "hazard_raster_test.bin";
+    const std::size_t TILE_SIZE = 16;
+
+    std::string readFile(const char* path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void writeFile(const char* path, const std::string& contents) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
+
+    bool check(bool condition, const char* what) {
+        if (!condition) std::fprintf(stderr, "FAIL %s\n", what);
+        return condition;
+    }
+
+    // Opening the raster must throw and leave the file as it was
+    bool refused(const char* what, const SiteGrid& grid, const RasterProvenance& provenance) {
+        std::string before = readFile(RASTER_PATH);
+        bool threw = false;
+        try {
+            HazardRasterWriter raster(RASTER_PATH, grid, provenance, TILE_SIZE);
+        } catch (const std::runtime_error& e) {
+            std::printf("refused %-22s %s\n", what, e.what());
+            threw = true;
+        }
+        return check(threw, what) & check(readFile(RASTER_PATH) == before, "a refused file was modified");
+    }
+
+    // Sites of the raster against the in-memory map, bit for bit
+    bool sameAsMap(const HazardRaster& raster, const HazardMap& map) {
+        for (std::size_t row = 0; row < map.Grid.Rows; ++row) {
+            for (std::size_t column = 0; column < map.Grid.Columns; ++column) {
+                double expected = map.PGA[row * map.Grid.Columns + column];
+                double actual = raster.getPGA(row, column);
+                if (std::memcmp(&expected, &actual, sizeof(double)) != 0) return false;
+                if (raster.getControllingFault(row, column) != map.ControllingFault[row * map.Grid.Columns + column]) return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace
+
+int main() {
+    FDSHAEngine engine;
+    std::vector<Fault> faults = {{37.0, 54.0, 7.0, 0.0}, {36.4, 55.2, 6.2, 0.05}, {37.8, 53.5, 7.6, -0.08}};
+    HazardMapGenerator generator(engine, faults);
+    RasterProvenance provenance = RasterProvenance::of(generator);
+    SiteGrid grid{36.0, 53.0, 2.0 / 49.0, 3.0 / 69.0, 50, 70};
+    ThreadPool pool(2);
+    HazardMap reference = generator.generate(grid, pool);
+    std::remove(RASTER_PATH);
+    bool passed = true;
+
+    // 1. An interrupted run: even tiles reached a checkpoint, odd tiles only hold stale values
+    std::vector<std::size_t> flagged;
+    {
+        HazardRasterWriter raster(RASTER_PATH, grid, provenance, TILE_SIZE);
+        for (std::size_t tile = 0; tile < raster.getTileCount(); ++tile) {
+            std::size_t rowBegin = (tile / raster.getTileColumns()) * TILE_SIZE;
+            std::size_t columnBegin = (tile % raster.getTileColumns()) * TILE_SIZE;
+            double* pga = raster.getTilePGA(tile);
+            std::int32_t* controlling = raster.getTileControllingFaults(tile);
+            for (std::size_t i = 0; i < TILE_SIZE * TILE_SIZE; ++i) {
+                std::size_t row = rowBegin + i / TILE_SIZE, column = columnBegin + i % TILE_SIZE;
+                bool site = row < grid.Rows && column < grid.Columns;
+                pga[i] = tile % 2 != 0 ? NAN : site ? reference.PGA[row * grid.Columns + column] : 0.0;
+                controlling[i] = tile % 2 != 0 ? 12345 : site ? reference.ControllingFault[row * grid.Columns + column] : NO_FAULT;
+            }
+            if (tile % 2 == 0) {
+                raster.markTileComplete(tile);
+                flagged.push_back(tile);
+            }
+        }
+    }
+
+    // 2. Resume: only the odd tiles are left, and the result matches the in-memory map
+    {
+        HazardRasterWriter raster(RASTER_PATH, grid, provenance, TILE_SIZE);
+        std::vector<std::size_t> incomplete = raster.getIncompleteTiles();
+        std::printf("resumed with %zu of %zu tiles left\n", incomplete.size(), raster.getTileCount());
+        bool onlyOdd = incomplete.size() + flagged.size() == raster.getTileCount();
+        for (std::size_t tile : incomplete) onlyOdd &= tile % 2 != 0;
+        passed &= check(onlyOdd, "resume does not recompute exactly the unflagged tiles");
+        generator.generate(raster, pool);
+    }
+    HazardRaster finished = HazardRaster::open(RASTER_PATH);
+    passed &= check(finished.countCompleteTiles() == finished.getTileCount(), "the resumed raster is incomplete");
+    passed &= check(sameAsMap(finished, reference), "the resumed raster differs from the in-memory map");
+    const std::string complete = readFile(RASTER_PATH);
+
+    // 3. Refusals, each leaving the file untouched
+    HazardMapGenerator otherCatalog(engine, {faults[0], faults[1]});
+    passed &= refused("other catalog", grid, RasterProvenance::of(otherCatalog));
+    SiteGrid otherGrid = grid;
+    otherGrid.Rows += 1;
+    passed &= refused("other grid", otherGrid, provenance);
+
+    std::string foreign(complete.size() / 2, '\0');
+    std::memcpy(&foreign[512], "not a raster", 12);
+    writeFile(RASTER_PATH, foreign);
+    passed &= refused("zero-prefixed file", grid, provenance);
+
+    writeFile(RASTER_PATH, complete.substr(0, complete.size() - 4096));
+    passed &= refused("truncated raster", grid, provenance);
+
+    // 4. Zeros of exactly the raster's size: killed before the header was written, started over
+    writeFile(RASTER_PATH, std::string(complete.size(), '\0'));
+    {
+        HazardRasterWriter raster(RASTER_PATH, grid, provenance, TILE_SIZE);
+        passed &= check(raster.getIncompleteTiles().size() == raster.getTileCount(), "a zeroed raster is not started over");
+        generator.generate(raster, pool);
+    }
+    passed &= check(readFile(RASTER_PATH) == complete, "a restarted raster differs from the resumed one");
+
+    std::remove(RASTER_PATH);
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+// Test for the PGA memo table: accounting, eviction and concurrent access.
+//
+// Every value the cache returns must be bit for bit the engine's findPGA at the input's grid point,
+// whichever path (findPGA or findPGABatch) filled the slot. Hits, misses, bypasses and entries must
+// add up exactly. A shard of PROBE_LIMIT slots must hold PROBE_LIMIT keys and evict one slot per
+// further key. Many threads sharing a small cache must agree with the single-threaded engine and
+// leave consistent totals.
+//
+// Build and run from fdsha_final/ (add -fsanitize=thread to also check for data races):
+//   g++ -std=c++17 -O2 -pthread -I. tests/PGACacheTest.cpp $(ls *.cpp | grep -v main.cpp) -o cache_test
+//   ./cache_test [THREADS]
+
+#include "FDSHAEngine.h"
+#include "PGACache.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace FDSHA;
+
+namespace {
+
+    const int ROUNDS = 16;
+
+    // Inputs on the default 0.01 / 0.01 / 0.001 grid, so the cached value is findPGA of the input
+    struct Inputs {
+        std::vector<double> Mmax, R, F;
+        std::size_t size() const { return Mmax.size(); }
+    };
+
+    Inputs gridInputs(std::size_t count, unsigned seed) {
+        std::mt19937 generator(seed);
+        std::uniform_int_distribution<int> mmax(450, 850), distance(0, 20000), faultType(-100, 100);
+        Inputs inputs;
+        for (std::size_t i = 0; i < count; ++i) {
+            inputs.Mmax.push_back(mmax(generator) / 100.0);
+            inputs.R.push_back(distance(generator) / 100.0);
+            inputs.F.push_back(faultType(generator) / 1000.0);
+        }
+        return inputs;
+    }
+
+    bool same(double a, double b) { return std::memcmp(&a, &b, sizeof(double)) == 0; }
+
+    bool check(bool condition, const char* what) {
+        if (!condition) std::fprintf(stderr, "FAIL %s\n", what);
+        return condition;
+    }
+
+    // Distinct inputs: first pass misses, second pass (batch) hits, both exact
+    bool testAccounting(const FDSHAEngine& engine) {
+        PGACache cache(engine);
+        Inputs inputs;
+        for (int m = 0; m < 10; ++m) {
+            for (int r = 0; r < 10; ++r) {
+                for (int f = 0; f < 5; ++f) {
+                    inputs.Mmax.push_back((500 + 30 * m) / 100.0);
+                    inputs.R.push_back((1000 + 1700 * r) / 100.0);
+                    inputs.F.push_back((-80 + 40 * f) / 1000.0);
+                }
+            }
+        }
+        const std::size_t n = inputs.size();
+        std::vector<double> expected(n);
+        for (std::size_t i = 0; i < n; ++i) expected[i] = engine.findPGA(inputs.Mmax[i], inputs.R[i], inputs.F[i]);
+
+        std::size_t wrong = 0;
+        for (std::size_t i = 0; i < n; ++i) wrong += !same(cache.findPGA(inputs.Mmax[i], inputs.R[i], inputs.F[i]), expected[i]);
+        CacheStatistics first = cache.getStatistics();
+        std::vector<double> batch(n);
+        cache.findPGABatch(inputs.Mmax.data(), inputs.R.data(), inputs.F.data(), batch.data(), n);
+        for (std::size_t i = 0; i < n; ++i) wrong += !same(batch[i], expected[i]);
+        CacheStatistics second = cache.getStatistics();
+
+        // NaN and unrepresentable inputs go straight to the engine
+        const double bypassed[][3] = {{NAN, 50.0, 0.0}, {7.0, NAN, 0.0}, {7.0, 1e300, 0.0}, {7.0, 50.0, -1e300}};
+        for (const auto& row : bypassed) wrong += !same(cache.findPGA(row[0], row[1], row[2]), engine.findPGA(row[0], row[1], row[2]));
+        CacheStatistics third = cache.getStatistics();
+        cache.clear();
+        CacheStatistics cleared = cache.getStatistics();
+
+        std::printf("accounting  %zu keys: first pass %llu/%llu hits/misses, second %llu/%llu, %llu bypasses\n", n,
+                    static_cast<unsigned long long>(first.Hits), static_cast<unsigned long long>(first.Misses),
+                    static_cast<unsigned long long>(second.Hits - first.Hits),
+                    static_cast<unsigned long long>(second.Misses - first.Misses),
+                    static_cast<unsigned long long>(third.Bypasses));
+        bool passed = check(wrong == 0, "cached values differ from findPGA");
+        passed &= check(first.Hits == 0 && first.Misses == n && first.Entries == n && first.Evictions == 0, "first pass accounting");
+        passed &= check(second.Hits == n && second.Misses == n && second.Entries == n, "second pass accounting");
+        passed &= check(third.Bypasses == 4 && third.Entries == n && third.Hits + third.Misses == 2 * n, "bypass accounting");
+        passed &= check(cleared.Hits == 0 && cleared.Misses == 0 && cleared.Bypasses == 0 && cleared.Entries == 0, "clear()");
+        return passed;
+    }
+
+    // One shard of exactly PROBE_LIMIT slots: the first PROBE_LIMIT keys fit, every later key evicts
+    bool testEviction(const FDSHAEngine& engine) {
+        CacheSettings settings;
+        settings.Capacity = PGACache::PROBE_LIMIT;
+        settings.Shards = 1;
+        PGACache cache(engine, settings);
+        const std::size_t keys = 3 * PGACache::PROBE_LIMIT;
+        Inputs inputs = gridInputs(keys, 3);
+
+        bool passed = check(cache.getCapacity() == PGACache::PROBE_LIMIT, "capacity of one PROBE_LIMIT shard");
+        std::size_t wrong = 0;
+        for (std::size_t i = 0; i < keys; ++i) {
+            wrong += !same(cache.findPGA(inputs.Mmax[i], inputs.R[i], inputs.F[i]), engine.findPGA(inputs.Mmax[i], inputs.R[i], inputs.F[i]));
+            CacheStatistics statistics = cache.getStatistics();
+            std::size_t expectedEvictions = i + 1 > PGACache::PROBE_LIMIT ? i + 1 - PGACache::PROBE_LIMIT : 0;
+            passed &= statistics.Evictions == expectedEvictions && statistics.Entries == std::min(i + 1, PGACache::PROBE_LIMIT);
+        }
+        check(passed, "evictions do not start at PROBE_LIMIT keys");
+
+        // Evicted keys are recomputed, never served stale
+        CacheStatistics before = cache.getStatistics();
+        for (std::size_t i = 0; i < keys; ++i) {
+            wrong += !same(cache.findPGA(inputs.Mmax[i], inputs.R[i], inputs.F[i]), engine.findPGA(inputs.Mmax[i], inputs.R[i], inputs.F[i]));
+        }
+        CacheStatistics after = cache.getStatistics();
+        std::printf("eviction    %zu keys into %zu slots: %llu evictions, %llu entries\n", keys, cache.getCapacity(),
+                    static_cast<unsigned long long>(before.Evictions), static_cast<unsigned long long>(before.Entries));
+        passed &= check(wrong == 0, "an evicting cache returned a wrong value");
+        passed &= check(after.Hits + after.Misses == 2 * keys && after.Entries == PGACache::PROBE_LIMIT, "eviction accounting");
+        return passed;
+    }
+
+    // Threads share a cache much smaller than the key set, mixing scalar and batch lookups
+    bool testConcurrency(const FDSHAEngine& engine, unsigned threads) {
+        CacheSettings settings;
+        settings.Capacity = 256;
+        settings.Shards = 4;
+        PGACache cache(engine, settings);
+        const Inputs inputs = gridInputs(2048, 7);
+        std::vector<double> expected(inputs.size());
+        for (std::size_t i = 0; i < inputs.size(); ++i) expected[i] = engine.findPGA(inputs.Mmax[i], inputs.R[i], inputs.F[i]);
+
+        std::atomic<std::size_t> mismatches{0};
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                std::vector<double> batch(inputs.size());
+                std::size_t wrong = 0;
+                for (int round = 0; round < ROUNDS; ++round) {
+                    std::size_t offset = (t * 997 + round * 131) % inputs.size();
+                    for (std::size_t k = 0; k < inputs.size(); ++k) {
+                        std::size_t i = (k + offset) % inputs.size();
+                        wrong += !same(cache.findPGA(inputs.Mmax[i], inputs.R[i], inputs.F[i]), expected[i]);
+                    }
+                    cache.findPGABatch(inputs.Mmax.data(), inputs.R.data(), inputs.F.data(), batch.data(), inputs.size());
+                    for (std::size_t i = 0; i < inputs.size(); ++i) wrong += !same(batch[i], expected[i]);
+                }
+                mismatches += wrong;
+            });
+        }
+        for (auto& worker : workers) worker.join();
+
+        CacheStatistics statistics = cache.getStatistics();
+        std::uint64_t lookups = std::uint64_t{threads} * ROUNDS * 2 * inputs.size();
+        std::printf("concurrency %u threads x %d rounds: %zu mismatches, %.1f%% hit rate, %llu evictions\n", threads, ROUNDS,
+                    mismatches.load(), 100.0 * statistics.hitRate(), static_cast<unsigned long long>(statistics.Evictions));
+        bool passed = check(mismatches.load() == 0, "concurrent lookups differ from findPGA");
+        passed &= check(statistics.Hits + statistics.Misses == lookups && statistics.Bypasses == 0, "concurrent accounting");
+        passed &= check(statistics.Entries <= cache.getCapacity(), "more entries than slots");
+        return passed;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // At least four threads, so the test interleaves even on small machines
+    unsigned threads = argc > 1 ? static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10))
+                                : std::max(4u, std::thread::hardware_concurrency());
+    if (threads == 0) {
+        std::fprintf(stderr, "Usage: %s [THREADS]\n", argv[0]);
+        return 2;
+    }
+
+    FDSHAEngine engine;
+    bool passed = testAccounting(engine);
+    passed &= testEviction(engine);
+    passed &= testConcurrency(engine, threads);
+    return passed ? 0 : 1;
+}
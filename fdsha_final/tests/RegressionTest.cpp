@@ -0,0 +1,135 @@
+// Regression test for the built-in model.
+//
+// tests/data/regression_grid.txt holds "Mmax R F PGA" lines (%.17g) computed by the original
+// polymorphic-set engine over a grid that spans and overshoots every universe. The current
+// engine must reproduce each PGA bit for bit.
+//
+// findPGASweep must stay within BATCH_TOLERANCE of findPGA (and currently matches it exactly) for
+// random sweeps along every axis, increasing or not, spanning and overshooting the universe, with
+// either defuzzifier.
+//
+// The default policies findPGAWith<>() must give exactly the sampled-COG findPGA, on the golden
+// grid and on random inputs, whatever defuzzification method the engine is set to.
+//
+// Build and run from fdsha_final/:
+//   g++ -std=c++17 -O2 -pthread -I. tests/RegressionTest.cpp $(ls *.cpp | grep -v main.cpp) -o regression_test
+//   ./regression_test [GOLDEN_FILE]
+
+#include "FDSHAEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace FDSHA;
+
+namespace {
+
+    const int SWEEPS = 900;
+    const int POLICY_INPUTS = 200000;
+    const std::size_t SWEEP_POINTS = 2000;
+
+    // Sweeps along random axes with random fixed inputs; every fourth sweep is left unsorted
+    bool checkSweeps(const FDSHAEngine& engine, const char* name) {
+        std::mt19937 generator(2024);
+        const InputAxis axes[3] = {InputAxis::Magnitude, InputAxis::Distance, InputAxis::FaultType};
+        const Universe universes[3] = {engine.getMagnitudeUniverse(), engine.getDistanceUniverse(), engine.getFaultTypeUniverse()};
+        std::size_t points = 0, outside = 0, identical = 0;
+        double maxError = 0.0;
+        std::vector<double> values(SWEEP_POINTS), sweep(SWEEP_POINTS);
+
+        for (int s = 0; s < SWEEPS; ++s) {
+            std::size_t varied = static_cast<std::size_t>(s % 3);
+            double fixed[3];
+            for (std::size_t v = 0; v < 3; ++v) {
+                double overshoot = 0.1 * (universes[v].Max - universes[v].Min);
+                fixed[v] = std::uniform_real_distribution<double>(universes[v].Min - overshoot, universes[v].Max + overshoot)(generator);
+            }
+            double overshoot = 0.1 * (universes[varied].Max - universes[varied].Min);
+            std::uniform_real_distribution<double> axis(universes[varied].Min - overshoot, universes[varied].Max + overshoot);
+            for (double& value : values) value = axis(generator);
+            if (s % 4 != 3) std::sort(values.begin(), values.end());
+
+            engine.findPGASweep(axes[varied], fixed[0], fixed[1], fixed[2], values.data(), sweep.data(), SWEEP_POINTS);
+            for (std::size_t i = 0; i < SWEEP_POINTS; ++i) {
+                double inputs[3] = {fixed[0], fixed[1], fixed[2]};
+                inputs[varied] = values[i];
+                double expected = engine.findPGA(inputs[0], inputs[1], inputs[2]);
+                double error = std::fabs(sweep[i] - expected);
+                if (!(error <= BATCH_TOLERANCE)) ++outside;
+                if (error > maxError || std::isnan(error)) maxError = error;
+                identical += std::memcmp(&sweep[i], &expected, sizeof(double)) == 0;
+                ++points;
+            }
+        }
+        std::printf("%zu/%zu %s sweep points bit-identical to findPGA (max deviation %.3g g)\n", identical, points, name, maxError);
+        if (outside != 0) {
+            std::fprintf(stderr, "FAIL %zu %s sweep points deviate from findPGA by more than %g\n", outside, name, BATCH_TOLERANCE);
+        }
+        return outside == 0;
+    }
+
+    // findPGAWith<>() against the sampled-COG findPGA; an exact-COG engine must not change it
+    bool checkDefaultPolicies(const FDSHAEngine& sampled) {
+        FDSHAEngine exact = sampled;
+        exact.setDefuzzificationMethod(DefuzzificationMethod::ExactCenterOfGravity);
+        std::mt19937 generator(19);
+        const Universe m = sampled.getMagnitudeUniverse(), r = sampled.getDistanceUniverse(), f = sampled.getFaultTypeUniverse();
+        std::uniform_real_distribution<double> mmax(m.Min - 0.5, m.Max + 0.5), distance(r.Min - 10.0, r.Max + 10.0),
+            faultType(f.Min - 0.05, f.Max + 0.05);
+
+        std::size_t failures = 0;
+        for (int i = 0; i < POLICY_INPUTS; ++i) {
+            double a = mmax(generator), b = distance(generator), c = faultType(generator);
+            double expected = sampled.findPGA(a, b, c);
+            double defaults = sampled.findPGAWith<>(a, b, c), ignoringMethod = exact.findPGAWith<>(a, b, c);
+            failures += std::memcmp(&defaults, &expected, sizeof(double)) != 0 || std::memcmp(&ignoringMethod, &expected, sizeof(double)) != 0;
+        }
+        std::printf("%d/%d random inputs: findPGAWith<>() bit-identical to findPGA\n", POLICY_INPUTS - static_cast<int>(failures),
+                    POLICY_INPUTS);
+        if (failures != 0) std::fprintf(stderr, "FAIL findPGAWith<>() differs from findPGA on %zu random inputs\n", failures);
+        return failures == 0;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* path = argc > 1 ? argv[1] : "tests/data/regression_grid.txt";
+    std::FILE* golden = std::fopen(path, "r");
+    if (golden == nullptr) {
+        std::fprintf(stderr, "cannot open %s\n", path);
+        return 2;
+    }
+
+    FDSHAEngine engine;
+    std::size_t rows = 0, failures = 0;
+    double mmax, r, f, expected;
+    while (std::fscanf(golden, "%lf %lf %lf %lf", &mmax, &r, &f, &expected) == 4) {
+        ++rows;
+        double actual = engine.findPGA(mmax, r, f);
+        double policies = engine.findPGAWith<>(mmax, r, f);
+        if (std::memcmp(&actual, &expected, sizeof(double)) != 0 || std::memcmp(&policies, &expected, sizeof(double)) != 0) {
+            if (++failures <= 10) {
+                std::fprintf(stderr, "FAIL findPGA(%.17g, %.17g, %.17g) = %.17g (findPGAWith<>() %.17g), expected %.17g\n", mmax,
+                             r, f, actual, policies, expected);
+            }
+        }
+    }
+    bool truncated = !std::feof(golden);
+    std::fclose(golden);
+
+    if (rows == 0 || truncated) {
+        std::fprintf(stderr, "FAIL %s is empty or malformed after %zu rows\n", path, rows);
+        return 1;
+    }
+    std::printf("%zu/%zu grid points bit-identical (findPGA and findPGAWith<>())\n", rows - failures, rows);
+    bool passed = failures == 0;
+    passed &= checkSweeps(engine, "sampled");
+    FDSHAEngine exact;
+    exact.setDefuzzificationMethod(DefuzzificationMethod::ExactCenterOfGravity);
+    passed &= checkSweeps(exact, "exact");
+    passed &= checkDefaultPolicies(engine);
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+// Accuracy test for the response surface on its default grid.
+//
+// measureError at 80 probes per axis and a set of random inputs must both stay within the bounds
+// below (measured: max 0.030 g, mean 4.1e-4 g; random max 0.031 g, mean 3.3e-4 g), and
+// measureError must not report a smaller maximum than a probe it actually covers.
+//
+// Build and run from fdsha_final/:
+//   g++ -std=c++17 -O2 -pthread -I. tests/ResponseSurfaceTest.cpp $(ls *.cpp | grep -v main.cpp) -o surface_test
+//   ./surface_test
+
+#include "FDSHAEngine.h"
+#include "ResponseSurface.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+using namespace FDSHA;
+
+namespace {
+
+    const std::size_t POINTS[3] = {81, 201, 41}; // --surface-points default
+    const std::size_t PROBES_PER_AXIS = 80;
+    const int RANDOM_INPUTS = 200000;
+
+    // In g, with some headroom over the measured values
+    const double MAX_ERROR = 0.035;
+    const double MEAN_ERROR = 1e-3;
+
+} // namespace
+
+int main() {
+    FDSHAEngine engine;
+    ResponseSurface surface = ResponseSurface::build(engine, POINTS[0], POINTS[1], POINTS[2]);
+
+    SurfaceErrorReport report = surface.measureError(engine, PROBES_PER_AXIS);
+    std::printf("measureError  %zu probes: max %.3e g, mean %.3e g\n", report.Samples, report.MaxAbsError, report.MeanAbsError);
+    bool passed = report.Samples == PROBES_PER_AXIS * PROBES_PER_AXIS * PROBES_PER_AXIS;
+    passed &= report.MaxAbsError <= MAX_ERROR && report.MeanAbsError <= MEAN_ERROR && report.MeanAbsError <= report.MaxAbsError;
+
+    // The first probe is the centre of the first cell of the probe grid
+    const GridAxis &m = surface.getMagnitudeAxis(), &r = surface.getDistanceAxis(), &f = surface.getFaultTypeAxis();
+    auto centre = [](const GridAxis& axis) { return axis.Min + 0.5 * (axis.Max - axis.Min) / static_cast<double>(PROBES_PER_AXIS); };
+    double firstProbe = std::fabs(surface.findPGA(centre(m), centre(r), centre(f)) - engine.findPGA(centre(m), centre(r), centre(f)));
+    passed &= firstProbe <= report.MaxAbsError + BATCH_TOLERANCE;
+
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<double> mmax(m.Min, m.Max), distance(r.Min, r.Max), faultType(f.Min, f.Max);
+    double maxError = 0.0, sumError = 0.0;
+    for (int i = 0; i < RANDOM_INPUTS; ++i) {
+        double a = mmax(generator), b = distance(generator), c = faultType(generator);
+        double error = std::fabs(surface.findPGA(a, b, c) - engine.findPGA(a, b, c));
+        maxError = std::max(maxError, error);
+        sumError += error;
+    }
+    double meanError = sumError / RANDOM_INPUTS;
+    std::printf("random        %d inputs: max %.3e g, mean %.3e g\n", RANDOM_INPUTS, maxError, meanError);
+    passed &= maxError <= MAX_ERROR && meanError <= MEAN_ERROR;
+
+    if (!passed) std::fprintf(stderr, "FAIL interpolation error exceeds %.3f g max or %.0e g mean\n", MAX_ERROR, MEAN_ERROR);
+    return passed ? 0 : 1;
+}